@@ -1,12 +1,48 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#if defined(WITH_SQLITE)
+#include "sqlite3.h"
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 // -----------------------------
 // Software Design Enhancements
 // -----------------------------
@@ -16,7 +52,40 @@
 // 4) Robust input handling using getline so filenames with spaces work.
 // 5) Data normalization (trim + uppercase course numbers) to reduce input defects.
 // 6) Use unordered_map keyed by courseNumber for scalable lookups.
-//    Keep sorted printing by sorting keys rather than sorting the container.
+//    Sorted listings are rendered once per loaded catalog and then reused.
+// 7) Batch eligibility: students are encoded as bitsets over dense course ids
+//    and checked against per-course prerequisite masks on worker threads.
+// 8) Term planning: prerequisite depths are cached at load time and reused by
+//    every planning request.
+// 9) Graph features (closure, dependents, topological order, cycle checks)
+//    run over a CSR adjacency built once per load.
+// 10) Single prerequisite edits keep a Pearce-Kelly topological order valid
+//     and reject cycles; the CSR rows and planner depths they touch are
+//     patched into a copy-on-write copy of the current snapshot.
+// 11) Loaded data lives in immutable snapshots published through an atomic
+//     pointer, so reloads and edits never block lookups on other threads.
+// 12) Server mode answers GET/LIST/RANGE/CLOSURE requests over a Unix socket
+//     from an epoll event loop (Linux only).
+// 13) A work-stealing thread pool runs server requests and batch eligibility;
+//     point lookups jump ahead of large listings, which split across workers.
+// 14) Batch mode runs scripted get/list/prereqs-all commands without prompts.
+// 15) Listings are written through a reusable output buffer with one write(2)
+//     per fill instead of iostream insertions per field.
+// 16) Large key sets (CSR build) are radix sorted on packed 8-byte prefixes
+//     instead of comparison sorted as std::string.
+// 17) The catalog can be exported as JSON or NDJSON, streamed through the
+//     output buffer without building a document in memory.
+// 18) Built with -DWITH_SQLITE (and linked against SQLite), --sql runs ad-hoc
+//     SQL over the loaded catalog through virtual tables that answer
+//     course_number constraints from the hash map and the sorted order.
+// 19) Title keyword search (batch "search", server SEARCH) uses an inverted
+//     index of block-compressed posting lists built with each snapshot.
+// 20) Course lookups that miss suggest near matches: trigram indexes over
+//     course numbers and title terms pick candidates, and a bit-parallel
+//     Levenshtein distance ranks them.
+// 21) Prefix completion (batch "complete", server COMPLETE) returns the first
+//     course numbers and the most common title words for a prefix from
+//     sorted arrays, with a sparse table ranking words by course count.
 
 // Holds course details
 struct Course {
@@ -46,6 +115,162 @@ static std::string toUpper(std::string s) {
     return s;
 }
 
+// Collects output in one reusable buffer and hands it to the OS with a
+// single write(2) per buffer fill instead of a stream insertion per field.
+// Listing a large catalog is then bound by the write, not by iostream.
+class OutputBuffer {
+public:
+    // Writes to stdout
+    explicit OutputBuffer(size_t capacity = 1 << 20) : buf(capacity), used(0) {}
+
+    // Writes to a new or truncated file; check isOpen() before use
+    explicit OutputBuffer(const std::string& path, size_t capacity = 1 << 20) : buf(capacity), used(0) {
+#if defined(__linux__)
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        ok = fd >= 0;
+#else
+        file.open(path, std::ios::binary | std::ios::trunc);
+        toFile = true;
+        ok = file.is_open();
+#endif
+    }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer() {
+        flush();
+#if defined(__linux__)
+        if (fd != STDOUT_FILENO && fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool isOpen() const {
+#if defined(__linux__)
+        return fd >= 0;
+#else
+        return !toFile || file.is_open();
+#endif
+    }
+
+    void append(const char* data, size_t n) {
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                writeOut(data, n);
+                return;
+            }
+        }
+        std::memcpy(buf.data() + used, data, n);
+        used += n;
+    }
+
+    void append(const std::string& s) {
+        append(s.data(), s.size());
+    }
+
+    void append(char ch) {
+        if (used == buf.size()) flush();
+        buf[used++] = ch;
+    }
+
+    // Fast path for "<number>, <title>\n" listing lines: one capacity check
+    // and three copies.
+    void appendCourseLine(const char* number, size_t numberLen, const char* title, size_t titleLen) {
+        const size_t n = numberLen + titleLen + 3;
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                append(number, numberLen);
+                append(", ", 2);
+                append(title, titleLen);
+                append('\n');
+                return;
+            }
+        }
+        char* p = buf.data() + used;
+        std::memcpy(p, number, numberLen);
+        p += numberLen;
+        *p++ = ',';
+        *p++ = ' ';
+        std::memcpy(p, title, titleLen);
+        p[titleLen] = '\n';
+        used += n;
+    }
+
+    void appendCourseLine(const std::string& number, const std::string& title) {
+        appendCourseLine(number.data(), number.size(), title.data(), title.size());
+    }
+
+    // Direct access for serializers: returns room for n bytes at the end of
+    // the buffer (nullptr if n exceeds its capacity); commit() then records
+    // how many of them were written.
+    char* reserve(size_t n) {
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) return nullptr;
+        }
+        return buf.data() + used;
+    }
+
+    void commit(size_t n) {
+        used += n;
+    }
+
+    void appendUnsigned(uint64_t value) {
+        char digits[20];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    // Write out everything buffered so far. Returns false once any write
+    // has failed.
+    bool flush() {
+        if (used > 0) {
+            writeOut(buf.data(), used);
+            used = 0;
+        }
+        return ok;
+    }
+
+private:
+    std::vector<char> buf;
+    size_t used;
+    bool ok = true;
+#if defined(__linux__)
+    int fd = STDOUT_FILENO;
+#else
+    std::ofstream file;
+    bool toFile = false;
+#endif
+
+    void writeOut(const char* data, size_t n) {
+#if defined(__linux__)
+        if (fd < 0) return;
+        if (fd == STDOUT_FILENO) {
+            // Earlier std::cout output (menu text) must reach the fd first
+            std::cout.flush();
+            std::fflush(stdout);
+        }
+        while (n > 0) {
+            const ssize_t written = ::write(fd, data, n);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                return;
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+        }
+#else
+        std::ostream& os = toFile ? static_cast<std::ostream&>(file) : std::cout;
+        os.write(data, static_cast<std::streamsize>(n));
+        os.flush();
+        ok = ok && static_cast<bool>(os);
+#endif
+    }
+};
+
 // Parse CSV file into an unordered_map keyed by course number
 // Returns true if file opened and parsed, false if file open fails.
 static bool loadCoursesFromCsv(
@@ -104,41 +329,21 @@ static bool loadCoursesFromCsv(
     return true;
 }
 
-// Print a sorted list of courses (sorted by course number)
-static void printCourseList(const std::unordered_map<std::string, Course>& courses) {
-    std::vector<std::string> keys;
-    keys.reserve(courses.size());
-
-    for (const auto& kv : courses) {
-        keys.push_back(kv.first);
-    }
-
-    std::sort(keys.begin(), keys.end());
-
-    for (const auto& key : keys) {
-        const Course& c = courses.at(key);
-        std::cout << c.courseNumber << ", " << c.title << '\n';
-    }
-}
-
-// Print a single course and its prerequisites
-static void printCourseDetails(const std::unordered_map<std::string, Course>& courses,
-    std::string courseNumber) {
-    courseNumber = toUpper(trim(courseNumber));
-
-    const auto it = courses.find(courseNumber);
-    if (it == courses.end()) {
+// Print a single course and its prerequisites. Returns false if the course
+// does not exist (course is null).
+static bool printCourseDetails(const Course* course) {
+    if (!course) {
         std::cout << "Error: Course not found\n";
-        return;
+        return false;
     }
 
-    const Course& c = it->second;
+    const Course& c = *course;
     std::cout << c.courseNumber << ", " << c.title << '\n';
 
     std::cout << "Prerequisites: ";
     if (c.prerequisites.empty()) {
         std::cout << "None\n";
-        return;
+        return true;
     }
 
     for (size_t i = 0; i < c.prerequisites.size(); ++i) {
@@ -148,75 +353,4570 @@ static void printCourseDetails(const std::unordered_map<std::string, Course>& co
         }
     }
     std::cout << '\n';
+    return true;
 }
 
-// Display the menu and return a validated integer choice
-static int displayMenu() {
-    std::cout << "\n1. Load Data Structure.\n";
-    std::cout << "2. Print Course List.\n";
-    std::cout << "3. Print Course.\n";
-    std::cout << "9. Exit\n";
-    std::cout << "What would you like to do? ";
+// -----------------------------
+// Course key sorting
+// -----------------------------
+// Building the CSR sorts every course number in the catalog (prerequisite
+// references included, before de-duplication). Comparison sorting
+// std::string keys chases a pointer and runs a memcmp per comparison, so
+// for large key sets the keys are radix sorted instead. Each key is packed
+// with its index into a 16-byte record whose 64-bit prefix holds 8 key bytes,
+// big-endian, starting at the current depth. Records are LSD radix sorted
+// on that prefix, skipping byte positions where every key has the same
+// byte (short keys and shared department codes skip most passes). Runs that
+// share a prefix move on to the next 8 bytes, or to std::sort once short.
+struct KeyRef {
+    uint64_t prefix;
+    uint32_t index;
+};
 
-    std::string input;
-    std::getline(std::cin, input);
+// Below this many keys std::sort wins on setup cost alone
+static const size_t kRadixSortThreshold = 1 << 14;
+// Equal-prefix runs up to this size finish with std::sort
+static const size_t kRadixSmallRun = 32;
 
-    input = trim(input);
-    if (input.empty()) {
-        return -1;
+// Keys shorter than the window are padded with zero bytes; sawNul records
+// a real zero byte, which padding alone cannot tell apart.
+static uint64_t packKeyPrefix(const std::string& key, size_t depth, bool& sawNul) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        const size_t pos = depth + i;
+        const unsigned char ch = pos < key.size() ? static_cast<unsigned char>(key[pos]) : 0;
+        sawNul = sawNul || (ch == 0 && pos < key.size());
+        prefix = (prefix << 8) | ch;
     }
+    return prefix;
+}
 
-    try {
-        return std::stoi(input);
+static void radixSortKeyRange(const std::vector<std::string>& keys, KeyRef* refs, KeyRef* tmp,
+    size_t n, size_t depth, bool sawNul) {
+    bool longer = false;
+    size_t counts[8][256] = {};
+    for (size_t i = 0; i < n; ++i) {
+        const std::string& key = keys[refs[i].index];
+        refs[i].prefix = packKeyPrefix(key, depth, sawNul);
+        longer = longer || key.size() > depth + 8;
+        for (size_t b = 0; b < 8; ++b) {
+            ++counts[b][(refs[i].prefix >> (8 * b)) & 0xFF];
+        }
     }
-    catch (...) {
-        return -1;
+
+    KeyRef* from = refs;
+    KeyRef* to = tmp;
+    for (size_t b = 0; b < 8; ++b) {
+        const unsigned shift = static_cast<unsigned>(8 * b);
+        if (counts[b][(from[0].prefix >> shift) & 0xFF] == n) continue;
+
+        size_t offsets[256];
+        size_t sum = 0;
+        for (size_t v = 0; v < 256; ++v) {
+            offsets[v] = sum;
+            sum += counts[b][v];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            to[offsets[(from[i].prefix >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != refs) {
+        std::copy(from, from + n, refs);
+    }
+
+    // If no key extends past this window, equal prefixes mean equal keys
+    // (unless a zero byte could be confused with padding)
+    if (!longer && !sawNul) return;
+
+    const auto byKey = [&keys](const KeyRef& a, const KeyRef& b) {
+        return keys[a.index] < keys[b.index];
+    };
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && refs[end].prefix == refs[begin].prefix) ++end;
+        if (longer && end - begin > kRadixSmallRun) {
+            radixSortKeyRange(keys, refs + begin, tmp + begin, end - begin, depth + 8, sawNul);
+        }
+        else if (end - begin > 1) {
+            std::sort(refs + begin, refs + end, byKey);
+        }
+        begin = end;
     }
 }
 
-int main() {
-    std::unordered_map<std::string, Course> courses;
-    bool dataLoaded = false;
+// Sort course numbers ascending. Same result as std::sort; large inputs
+// take the radix path.
+static void sortCourseNumbers(std::vector<std::string>& keys) {
+    if (keys.size() < kRadixSortThreshold || keys.size() > std::numeric_limits<uint32_t>::max()) {
+        std::sort(keys.begin(), keys.end());
+        return;
+    }
 
-    std::cout << "Welcome to the course planner.\n";
+    std::vector<KeyRef> refs(keys.size());
+    std::vector<KeyRef> tmp(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        refs[i].index = static_cast<uint32_t>(i);
+    }
+    radixSortKeyRange(keys, refs.data(), tmp.data(), refs.size(), 0, false);
 
-    while (true) {
-        int choice = displayMenu();
+    std::vector<std::string> sorted;
+    sorted.reserve(keys.size());
+    for (const KeyRef& r : refs) {
+        sorted.push_back(std::move(keys[r.index]));
+    }
+    keys.swap(sorted);
+}
 
-        switch (choice) {
-        case 1: {
-            std::cout << "Enter file name: ";
-            std::string filename;
-            std::getline(std::cin, filename);
+// -----------------------------
+// Prerequisite graph (CSR)
+// -----------------------------
+// Built once per load next to the course map. Every course number, including
+// prerequisites missing from the catalog, gets a dense uint32_t id in sorted
+// order, and edges are stored in compressed sparse row form:
+//   prerequisites of id: targets[offsets[id] .. offsets[id + 1])
+//   dependents of id:    revTargets[revOffsets[id] .. revOffsets[id + 1])
+// Traversals walk flat integer arrays instead of resolving names through the
+// hash map at every step.
+//
+// The rows are cut into pages of kRowsPerPage ids, each page a small CSR of
+// its own behind a shared pointer, and the course numbers sit in one shared
+// CourseIds. Copying a graph copies page pointers only, and a prerequisite
+// edit clones just the page each changed row lives in, so a snapshot built
+// by an edit shares every other page with the snapshot it came from.
+static constexpr uint32_t kRowsPerPage = 4096;
 
-            if (!loadCoursesFromCsv(filename, courses)) {
-                std::cout << "Error: File not found or could not be opened\n";
-                dataLoaded = false;
+// One adjacency row, read-only
+struct IdRow {
+    const uint32_t* first;
+    const uint32_t* last;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+};
+
+class AdjacencyRows {
+public:
+    AdjacencyRows() = default;
+
+    // Split a flat CSR into pages
+    AdjacencyRows(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& targets) {
+        const uint32_t rows = static_cast<uint32_t>(offsets.size() - 1);
+        for (uint32_t first = 0; first < rows; first += kRowsPerPage) {
+            const uint32_t last = std::min(rows, first + kRowsPerPage);
+            auto page = std::make_shared<Page>();
+            page->rows = last - first;
+            for (uint32_t id = first; id <= last; ++id) {
+                page->offsets[id - first] = offsets[id] - offsets[first];
             }
-            else {
-                std::cout << "Data loaded successfully.\n";
-                dataLoaded = true;
+            page->targets.assign(targets.begin() + offsets[first], targets.begin() + offsets[last]);
+            pages.push_back(std::move(page));
+        }
+    }
+
+    IdRow operator[](uint32_t id) const {
+        const Page& page = *pages[id / kRowsPerPage];
+        const uint32_t r = id % kRowsPerPage;
+        const uint32_t* targets = page.targets.data();
+        return { targets + page.offsets[r], targets + page.offsets[r + 1] };
+    }
+
+    // Insert value into row id ahead of its at-th entry
+    void insert(uint32_t id, size_t at, uint32_t value) {
+        Page& page = writable(id);
+        const uint32_t r = id % kRowsPerPage;
+        page.targets.insert(page.targets.begin() + page.offsets[r] + at, value);
+        for (uint32_t i = r + 1; i <= page.rows; ++i) ++page.offsets[i];
+    }
+
+    // Remove every copy of value from row id
+    void erase(uint32_t id, uint32_t value) {
+        const IdRow row = (*this)[id];
+        if (std::find(row.begin(), row.end(), value) == row.end()) return;
+
+        Page& page = writable(id);
+        const uint32_t r = id % kRowsPerPage;
+        const auto first = page.targets.begin() + page.offsets[r];
+        const auto last = page.targets.begin() + page.offsets[r + 1];
+        const auto kept = std::remove(first, last, value);
+        const uint32_t removed = static_cast<uint32_t>(last - kept);
+        page.targets.erase(kept, last);
+        for (uint32_t i = r + 1; i <= page.rows; ++i) page.offsets[i] -= removed;
+    }
+
+private:
+    struct Page {
+        uint32_t rows = 0;
+        uint32_t offsets[kRowsPerPage + 1];  // row offsets within targets
+        std::vector<uint32_t> targets;
+    };
+    std::vector<std::shared_ptr<Page>> pages;
+
+    // Pages are only ever shared between copies, never handed out, so a
+    // page nobody else holds can be written in place
+    Page& writable(uint32_t id) {
+        std::shared_ptr<Page>& page = pages[id / kRowsPerPage];
+        if (page.use_count() != 1) page = std::make_shared<Page>(*page);
+        return *page;
+    }
+};
+
+// Per-course values in copy-on-write pages, laid out like AdjacencyRows
+template <typename T>
+class PagedArray {
+public:
+    PagedArray() = default;
+
+    explicit PagedArray(const std::vector<T>& values) {
+        for (size_t first = 0; first < values.size(); first += kRowsPerPage) {
+            const size_t last = std::min(values.size(), first + kRowsPerPage);
+            pages.push_back(std::make_shared<std::vector<T>>(values.begin() + first, values.begin() + last));
+        }
+    }
+
+    const T& operator[](uint32_t id) const { return (*pages[id / kRowsPerPage])[id % kRowsPerPage]; }
+
+    void set(uint32_t id, const T& value) {
+        std::shared_ptr<std::vector<T>>& page = pages[id / kRowsPerPage];
+        if (page.use_count() != 1) page = std::make_shared<std::vector<T>>(*page);
+        (*page)[id % kRowsPerPage] = value;
+    }
+
+private:
+    std::vector<std::shared_ptr<std::vector<T>>> pages;
+};
+
+// Dense ids for every course number in one load
+struct CourseIds {
+    std::vector<std::string> names;                 // id -> course number
+    std::unordered_map<std::string, uint32_t> ids;  // course number -> id
+    std::vector<uint8_t> inCatalog;                 // 1 if names[id] has a course record
+};
+
+struct PrerequisiteGraph {
+    std::shared_ptr<const CourseIds> keys;
+    AdjacencyRows prerequisites;  // in the course's own list order
+    AdjacencyRows dependents;     // in id order
+
+    size_t size() const { return keys->names.size(); }
+    const std::string& name(uint32_t id) const { return keys->names[id]; }
+    bool inCatalog(uint32_t id) const { return keys->inCatalog[id] != 0; }
+
+    int idOf(const std::string& courseNumber) const {
+        const auto it = keys->ids.find(courseNumber);
+        return it == keys->ids.end() ? -1 : static_cast<int>(it->second);
+    }
+};
+
+// If catalogOrder is given, it receives a pointer to every catalog course in
+// course-number order, collected from lookups the build does anyway.
+static PrerequisiteGraph buildPrerequisiteGraph(
+    const std::unordered_map<std::string, Course>& courses,
+    std::vector<const Course*>* catalogOrder = nullptr
+) {
+    auto keys = std::make_shared<CourseIds>();
+    std::vector<std::string>& names = keys->names;
+
+    for (const auto& kv : courses) {
+        names.push_back(kv.first);
+        for (const auto& p : kv.second.prerequisites) {
+            names.push_back(p);
+        }
+    }
+    sortCourseNumbers(names);
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    const size_t n = names.size();
+    keys->ids.reserve(n);
+    keys->inCatalog.assign(n, 0);
+    for (uint32_t id = 0; id < n; ++id) {
+        keys->ids.emplace(names[id], id);
+    }
+
+    // Forward edges, emitted in id order so offsets can be filled in one pass
+    std::vector<uint32_t> offsets(n + 1, 0), targets;
+    for (uint32_t id = 0; id < n; ++id) {
+        const auto it = courses.find(names[id]);
+        if (it != courses.end()) {
+            keys->inCatalog[id] = 1;
+            if (catalogOrder) catalogOrder->push_back(&it->second);
+            for (const auto& p : it->second.prerequisites) {
+                targets.push_back(keys->ids.at(p));
             }
-            break;
         }
-        case 2:
-            if (!dataLoaded) {
-                std::cout << "Please load data first using option 1.\n";
-                break;
+        offsets[id + 1] = static_cast<uint32_t>(targets.size());
+    }
+
+    // Reverse edges by counting sort over the forward edge list
+    std::vector<uint32_t> revOffsets(n + 1, 0), revTargets(targets.size());
+    for (uint32_t t : targets) {
+        ++revOffsets[t + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        revOffsets[i + 1] += revOffsets[i];
+    }
+    std::vector<uint32_t> fill(revOffsets.begin(), revOffsets.end() - 1);
+    for (uint32_t id = 0; id < n; ++id) {
+        for (uint32_t e = offsets[id]; e < offsets[id + 1]; ++e) {
+            revTargets[fill[targets[e]]++] = id;
+        }
+    }
+
+    PrerequisiteGraph g;
+    g.keys = std::move(keys);
+    g.prerequisites = AdjacencyRows(offsets, targets);
+    g.dependents = AdjacencyRows(revOffsets, revTargets);
+    return g;
+}
+
+// Visited marks that reset in O(1) by bumping an epoch instead of clearing
+// the whole array, so repeated traversals only pay for the nodes they touch.
+struct VisitMarks {
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+
+    void reset(size_t n) {
+        // Stamps added by growing are 0, older than any epoch after this one
+        if (stamp.size() < n) {
+            stamp.resize(n, 0);
+        }
+        if (++epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    // Returns true the first time id is marked since the last reset
+    bool mark(uint32_t id) {
+        if (stamp[id] == epoch) return false;
+        stamp[id] = epoch;
+        return true;
+    }
+};
+
+// Breadth-first closure over prerequisite edges (or dependent edges when
+// reverse is true). Starting ids are not included in the output. Ids already
+// marked by the caller are skipped, which lets callers exclude completed
+// courses before the traversal starts.
+static void collectClosure(
+    const PrerequisiteGraph& g,
+    const std::vector<uint32_t>& start,
+    bool reverse,
+    VisitMarks& marks,
+    std::vector<uint32_t>& out
+) {
+    const AdjacencyRows& rows = reverse ? g.dependents : g.prerequisites;
+
+    const size_t first = out.size();
+    for (uint32_t s : start) {
+        for (uint32_t w : rows[s]) {
+            if (marks.mark(w)) out.push_back(w);
+        }
+    }
+    for (size_t i = first; i < out.size(); ++i) {
+        for (uint32_t w : rows[out[i]]) {
+            if (marks.mark(w)) out.push_back(w);
+        }
+    }
+}
+
+// Kahn's algorithm over the CSR: prerequisites come before the courses that
+// need them, and among ready courses the lowest course number goes first.
+// That keeps the order close to catalog numbering, which keeps incremental
+// reorders local. Returns false if a cycle leaves some courses unordered.
+static bool topologicalOrder(const PrerequisiteGraph& g, std::vector<uint32_t>& orderOut) {
+    const size_t n = g.size();
+    std::vector<uint32_t> pending(n);
+    std::vector<uint32_t> ready;
+    orderOut.clear();
+    orderOut.reserve(n);
+
+    for (uint32_t id = 0; id < n; ++id) {
+        pending[id] = static_cast<uint32_t>(g.prerequisites[id].size());
+        if (pending[id] == 0) ready.push_back(id);
+    }
+    std::make_heap(ready.begin(), ready.end(), std::greater<uint32_t>());
+    while (!ready.empty()) {
+        std::pop_heap(ready.begin(), ready.end(), std::greater<uint32_t>());
+        const uint32_t v = ready.back();
+        ready.pop_back();
+        orderOut.push_back(v);
+
+        for (uint32_t w : g.dependents[v]) {
+            if (--pending[w] == 0) {
+                ready.push_back(w);
+                std::push_heap(ready.begin(), ready.end(), std::greater<uint32_t>());
             }
-            std::cout << "Here is a sample schedule:\n";
-            printCourseList(courses);
-            break;
+        }
+    }
+    return orderOut.size() == n;
+}
 
-        case 3: {
-            if (!dataLoaded) {
-                std::cout << "Please load data first using option 1.\n";
-                break;
+// Print every course a course depends on, directly or indirectly, and every
+// course that eventually requires it
+static void printPrerequisiteClosure(const PrerequisiteGraph& g, std::string courseNumber) {
+    courseNumber = toUpper(trim(courseNumber));
+
+    const int id = g.idOf(courseNumber);
+    if (id < 0 || !g.inCatalog(static_cast<uint32_t>(id))) {
+        std::cout << "Error: Course not found\n";
+        return;
+    }
+
+    VisitMarks marks;
+    std::vector<uint32_t> ids;
+    const std::vector<uint32_t> start{ static_cast<uint32_t>(id) };
+
+    auto printIds = [&](const char* label) {
+        std::sort(ids.begin(), ids.end()); // ids are assigned in course-number order
+        std::cout << label;
+        if (ids.empty()) {
+            std::cout << "None\n";
+            return;
+        }
+        for (size_t i = 0; i < ids.size(); ++i) {
+            std::cout << g.name(ids[i]);
+            if (i + 1 < ids.size()) std::cout << ", ";
+        }
+        std::cout << '\n';
+    };
+
+    marks.reset(g.size());
+    marks.mark(start[0]);
+    collectClosure(g, start, false, marks, ids);
+    printIds("All prerequisites: ");
+
+    ids.clear();
+    marks.reset(g.size());
+    marks.mark(start[0]);
+    collectClosure(g, start, true, marks, ids);
+    printIds("Required by: ");
+}
+
+// -----------------------------
+// Incremental topological order
+// -----------------------------
+// Pearce-Kelly dynamic topological order for single prerequisite edits.
+// Seeded from the CSR at load time, then kept valid edge by edge: adding
+// "course requires prereq" only reorders the courses whose positions lie
+// between the two endpoints and are reachable from them, and an edge that
+// would close a cycle is detected during that same search and rejected.
+// Removing an edge never invalidates the order.
+class DynamicTopoOrder {
+public:
+    // Seed from a loaded graph. Returns false if the graph has a cycle.
+    bool reset(const PrerequisiteGraph& g) {
+        names = g.keys->names;
+        ids = g.keys->ids;
+        prereqs.assign(g.size(), {});
+        dependents.assign(g.size(), {});
+        for (uint32_t id = 0; id < g.size(); ++id) {
+            const IdRow row = g.prerequisites[id];
+            prereqs[id].assign(row.begin(), row.end());
+            const IdRow rev = g.dependents[id];
+            dependents[id].assign(rev.begin(), rev.end());
+        }
+
+        valid = topologicalOrder(g, at);
+        ord.assign(g.size(), 0);
+        for (uint32_t pos = 0; pos < at.size(); ++pos) {
+            ord[at[pos]] = pos;
+        }
+        return valid;
+    }
+
+    bool isValid() const { return valid; }
+
+    // Position of a course in the current order; a course's prerequisites
+    // always have smaller positions
+    uint32_t position(uint32_t id) const { return ord[id]; }
+
+    // True if every prerequisite edge points backward in the order
+    bool verify() const {
+        for (uint32_t c = 0; c < prereqs.size(); ++c) {
+            for (uint32_t p : prereqs[c]) {
+                if (ord[p] >= ord[c]) return false;
             }
-            std::cout << "What course do you want to know about? ";
-            std::string courseNumber;
-            std::getline(std::cin, courseNumber);
-            printCourseDetails(courses, courseNumber);
+        }
+        return true;
+    }
+
+    // Record that course requires prereq. Returns false, leaving the order
+    // untouched, if the edge would create a prerequisite cycle.
+    bool addEdge(const std::string& course, const std::string& prereq) {
+        const uint32_t c = idFor(course);
+        const uint32_t p = idFor(prereq);
+        if (c == p) return false;
+        if (std::find(prereqs[c].begin(), prereqs[c].end(), p) != prereqs[c].end()) {
+            return true; // already present
+        }
+
+        const uint32_t lower = ord[c];
+        const uint32_t upper = ord[p];
+        if (upper < lower) {
+            link(c, p); // already in order
+            return true;
+        }
+
+        // Forward search from the course through its dependents, limited to
+        // positions up to the prerequisite. Reaching the prerequisite means
+        // it already depends on the course.
+        std::vector<uint32_t> forward;
+        marks.reset(names.size());
+        if (!search(c, upper, true, p, forward)) {
+            return false;
+        }
+
+        // Backward search from the prerequisite through its own
+        // prerequisites, limited to positions from the course onward.
+        std::vector<uint32_t> backward;
+        search(p, lower, false, p, backward);
+
+        // Reuse the positions both sets occupied, placing everything the
+        // prerequisite needs ahead of everything that needs the course.
+        auto byOrder = [this](uint32_t a, uint32_t b) { return ord[a] < ord[b]; };
+        std::sort(forward.begin(), forward.end(), byOrder);
+        std::sort(backward.begin(), backward.end(), byOrder);
+
+        std::vector<uint32_t> slots;
+        slots.reserve(forward.size() + backward.size());
+        for (uint32_t v : backward) slots.push_back(ord[v]);
+        for (uint32_t v : forward) slots.push_back(ord[v]);
+        std::sort(slots.begin(), slots.end());
+
+        size_t i = 0;
+        for (uint32_t v : backward) place(v, slots[i++]);
+        for (uint32_t v : forward) place(v, slots[i++]);
+
+        link(c, p);
+        return true;
+    }
+
+    void removeEdge(const std::string& course, const std::string& prereq) {
+        const auto c = ids.find(course);
+        const auto p = ids.find(prereq);
+        if (c == ids.end() || p == ids.end()) return;
+
+        auto& out = prereqs[c->second];
+        out.erase(std::remove(out.begin(), out.end(), p->second), out.end());
+        auto& in = dependents[p->second];
+        in.erase(std::remove(in.begin(), in.end(), c->second), in.end());
+    }
+
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::vector<uint32_t>> prereqs;     // course -> prerequisites
+    std::vector<std::vector<uint32_t>> dependents;  // prerequisite -> courses
+    std::vector<uint32_t> ord;                      // id -> position
+    std::vector<uint32_t> at;                       // position -> id
+    VisitMarks marks;
+    bool valid = false;
+
+    // New course numbers are appended at the end of the order
+    uint32_t idFor(const std::string& name) {
+        const auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+
+        const uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        prereqs.emplace_back();
+        dependents.emplace_back();
+        ord.push_back(static_cast<uint32_t>(at.size()));
+        at.push_back(id);
+        return id;
+    }
+
+    void link(uint32_t course, uint32_t prereq) {
+        prereqs[course].push_back(prereq);
+        dependents[prereq].push_back(course);
+    }
+
+    void place(uint32_t id, uint32_t pos) {
+        ord[id] = pos;
+        at[pos] = id;
+    }
+
+    // Iterative DFS bounded by position. Forward searches follow dependents
+    // and stay at or below bound; backward searches follow prerequisites and
+    // stay at or above it. Returns false if a forward search reaches stop.
+    bool search(uint32_t start, uint32_t bound, bool forwardDir, uint32_t stop,
+        std::vector<uint32_t>& visited) {
+        std::vector<uint32_t> stack{ start };
+        marks.mark(start);
+        while (!stack.empty()) {
+            const uint32_t v = stack.back();
+            stack.pop_back();
+            visited.push_back(v);
+
+            for (uint32_t w : forwardDir ? dependents[v] : prereqs[v]) {
+                if (forwardDir && w == stop) return false;
+                const bool inRange = forwardDir ? ord[w] <= bound : ord[w] >= bound;
+                if (inRange && marks.mark(w)) {
+                    stack.push_back(w);
+                }
+            }
+        }
+        return true;
+    }
+};
+
+// -----------------------------
+// Work-stealing executor
+// -----------------------------
+// A fixed set of workers, each owning a deque of tasks. A worker pops its
+// own newest task first (good cache locality for subtasks it just split
+// off); an idle worker steals the oldest task from a randomly chosen victim.
+// Latency-sensitive work (point lookups) goes to a separate urgent queue
+// that every worker checks before touching its deque, so a GET never waits
+// behind the remaining chunks of a large listing.
+//
+// Large requests call parallelFor, which pushes the chunks onto the calling
+// worker's deque and then helps run tasks until all of its chunks are done.
+// The caller therefore stays inside the call (and keeps any snapshot it has
+// pinned) while other workers steal and run the chunks.
+class WorkStealingPool {
+public:
+    struct QueueStats {
+        size_t depth;
+        uint64_t executed;
+        uint64_t steals;
+    };
+
+    explicit WorkStealingPool(size_t threads) : queues(std::max<size_t>(1, threads)) {
+        for (size_t i = 0; i < queues.size(); ++i) {
+            workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Tasks still queued at destruction are dropped
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    size_t size() const { return queues.size(); }
+
+    // Queue a small task ahead of all bulk work
+    void submitUrgent(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(urgentMutex);
+            urgent.push_back(std::move(task));
+        }
+        signalQueued();
+    }
+
+    // Queue bulk work. From a worker it goes on that worker's own deque;
+    // from any other thread the deques are filled round-robin.
+    void submit(std::function<void()> task) {
+        const size_t target = currentWorker() >= 0
+            ? static_cast<size_t>(currentWorker())
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        pushBack(target, std::move(task));
+        signalQueued();
+    }
+
+    // Run body(0) .. body(chunks - 1) across the pool and return when all of
+    // them have finished. The calling thread runs tasks while it waits.
+    void parallelFor(size_t chunks, const std::function<void(size_t)>& body) {
+        if (chunks == 0) return;
+
+        std::atomic<size_t> remaining{ chunks };
+        for (size_t i = 1; i < chunks; ++i) {
+            submit([&body, &remaining, i]() {
+                body(i);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        body(0);
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+        const int self = currentWorker();
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne(self)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t urgentDepth() const {
+        std::lock_guard<std::mutex> lock(urgentMutex);
+        return urgent.size();
+    }
+
+    std::vector<QueueStats> stats() const {
+        std::vector<QueueStats> out;
+        for (const auto& q : queues) {
+            out.push_back({ q.depth.load(std::memory_order_relaxed),
+                q.executed.load(std::memory_order_relaxed),
+                q.steals.load(std::memory_order_relaxed) });
+        }
+        return out;
+    }
+
+private:
+    struct alignas(64) WorkerQueue {
+        mutable std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::atomic<size_t> depth{ 0 };
+        std::atomic<uint64_t> executed{ 0 };
+        std::atomic<uint64_t> steals{ 0 };
+    };
+
+    std::vector<WorkerQueue> queues;
+    std::vector<std::thread> workers;
+    mutable std::mutex urgentMutex;
+    std::deque<std::function<void()>> urgent;
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Index of the worker running on this thread in this pool, or -1
+    int currentWorker() const {
+        return workerPool == this ? workerIndex : -1;
+    }
+
+    static thread_local const WorkStealingPool* workerPool;
+    static thread_local int workerIndex;
+
+    void signalQueued() {
+        queued.fetch_add(1, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+
+    void pushBack(size_t q, std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(queues[q].mutex);
+        queues[q].tasks.push_back(std::move(task));
+        queues[q].depth.store(queues[q].tasks.size(), std::memory_order_relaxed);
+    }
+
+    bool popUrgent(std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(urgentMutex);
+        if (urgent.empty()) return false;
+        task = std::move(urgent.front());
+        urgent.pop_front();
+        return true;
+    }
+
+    // Owner takes from the back (LIFO), thieves from the front (FIFO)
+    bool pop(size_t q, bool fromBack, std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(queues[q].mutex);
+        auto& tasks = queues[q].tasks;
+        if (tasks.empty()) return false;
+        if (fromBack) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        }
+        else {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        queues[q].depth.store(tasks.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Find and run one task: urgent queue, own deque, then random victims.
+    // self is -1 for threads outside the pool. Returns false if idle.
+    bool runOne(int self) {
+        std::function<void()> task;
+        bool stolen = false;
+
+        bool found = popUrgent(task);
+        if (!found && self >= 0) {
+            found = pop(static_cast<size_t>(self), true, task);
+        }
+        if (!found) {
+            thread_local uint64_t seed = 0x9E3779B97F4A7C15ULL ^
+                std::hash<std::thread::id>()(std::this_thread::get_id());
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+
+            const size_t n = queues.size();
+            const size_t start = static_cast<size_t>(seed % n);
+            for (size_t k = 0; k < n && !found; ++k) {
+                const size_t victim = (start + k) % n;
+                if (static_cast<int>(victim) == self) continue;
+                found = stolen = pop(victim, false, task);
+            }
+        }
+        if (!found) return false;
+
+        queued.fetch_sub(1, std::memory_order_acq_rel);
+        task();
+        if (self >= 0) {
+            queues[self].executed.fetch_add(1, std::memory_order_relaxed);
+            if (stolen) queues[self].steals.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void workerLoop(size_t index) {
+        workerPool = this;
+        workerIndex = static_cast<int>(index);
+
+        while (true) {
+            if (runOne(workerIndex)) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() {
+                return stopping || queued.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping) return;
+        }
+    }
+};
+
+thread_local const WorkStealingPool* WorkStealingPool::workerPool = nullptr;
+thread_local int WorkStealingPool::workerIndex = -1;
+
+// -----------------------------
+// Batch eligibility engine
+// -----------------------------
+// A student is a bitset over prerequisite-graph ids. A catalog course is
+// eligible when the student has not completed it and every bit of its
+// prerequisite mask is set. Masks are stored sparsely as (word, bits) pairs
+// because most courses only touch one or two 64-bit words of the bitset.
+struct EligibilityIndex {
+    std::vector<uint32_t> catalogIds;               // catalog course ids, sorted by number
+    std::vector<uint32_t> maskBegin;                // catalogIds[i] -> first mask entry
+    std::vector<uint32_t> maskWord;
+    std::vector<uint64_t> maskBits;
+    size_t words = 0;                               // 64-bit words per student bitset
+};
+
+static EligibilityIndex buildEligibilityIndex(const PrerequisiteGraph& g) {
+    EligibilityIndex idx;
+
+    for (uint32_t id = 0; id < g.size(); ++id) {
+        if (g.inCatalog(id)) {
+            idx.catalogIds.push_back(id);
+        }
+    }
+    idx.words = (g.size() + 63) / 64;
+
+    std::vector<std::pair<uint32_t, uint64_t>> mask;
+    idx.maskBegin.reserve(idx.catalogIds.size() + 1);
+    for (uint32_t id : idx.catalogIds) {
+        idx.maskBegin.push_back(static_cast<uint32_t>(idx.maskWord.size()));
+
+        mask.clear();
+        for (uint32_t pid : g.prerequisites[id]) {
+            mask.emplace_back(pid >> 6, uint64_t{1} << (pid & 63));
+        }
+        std::sort(mask.begin(), mask.end());
+
+        // Merge prerequisites that share a word into a single mask entry
+        for (size_t i = 0; i < mask.size(); ++i) {
+            if (idx.maskWord.size() > idx.maskBegin.back() && idx.maskWord.back() == mask[i].first) {
+                idx.maskBits.back() |= mask[i].second;
+            }
+            else {
+                idx.maskWord.push_back(mask[i].first);
+                idx.maskBits.push_back(mask[i].second);
+            }
+        }
+    }
+    idx.maskBegin.push_back(static_cast<uint32_t>(idx.maskWord.size()));
+
+    return idx;
+}
+
+// Parse one "studentId,COURSE,COURSE,..." line into the student bitset.
+// Returns false for blank or malformed lines.
+static bool parseStudentLine(
+    const PrerequisiteGraph& g,
+    const char* begin, const char* end,
+    std::string& studentIdOut,
+    std::vector<uint64_t>& completedOut
+) {
+    std::fill(completedOut.begin(), completedOut.end(), 0);
+
+    std::string field;
+    bool first = true;
+    const char* p = begin;
+    while (true) {
+        const char* comma = std::find(p, end, ',');
+        field.assign(p, comma);
+        field = trim(field);
+
+        if (first) {
+            if (field.empty()) {
+                return false;
+            }
+            studentIdOut = field;
+            first = false;
+        }
+        else if (!field.empty()) {
+            const int id = g.idOf(toUpper(field));
+            if (id >= 0) {
+                completedOut[id >> 6] |= uint64_t{1} << (id & 63);
+            }
+        }
+        if (comma == end) {
+            break;
+        }
+        p = comma + 1;
+    }
+    return !first;
+}
+
+// Append "studentId,ELIGIBLE,ELIGIBLE,...\n" for one student
+static void appendEligibleCourses(
+    const PrerequisiteGraph& g,
+    const EligibilityIndex& idx,
+    const std::string& studentId,
+    const uint64_t* completed,
+    std::string& out
+) {
+    out += studentId;
+
+    const size_t count = idx.catalogIds.size();
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t id = idx.catalogIds[i];
+        if ((completed[id >> 6] >> (id & 63)) & 1) {
+            continue; // already taken
+        }
+
+        // AND the student's words with the mask and compare; any missing
+        // prerequisite bit leaves a nonzero difference.
+        uint64_t missing = 0;
+        for (uint32_t k = idx.maskBegin[i]; k < idx.maskBegin[i + 1]; ++k) {
+            missing |= (completed[idx.maskWord[k]] & idx.maskBits[k]) ^ idx.maskBits[k];
+        }
+        if (missing == 0) {
+            out += ',';
+            out += g.name(id);
+        }
+    }
+    out += '\n';
+}
+
+// Evaluate every student in studentsFile and write one CSV line per student
+// to outputFile. Lines are split evenly across hardware threads; each thread
+// renders into its own buffer so output order matches input order.
+// Returns false if either file cannot be opened.
+static bool runEligibilityBatch(
+    const PrerequisiteGraph& g,
+    const std::string& studentsFile,
+    const std::string& outputFile,
+    WorkStealingPool& pool,
+    size_t& studentsOut
+) {
+    std::ifstream in(studentsFile, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::ofstream out(outputFile, std::ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    const EligibilityIndex idx = buildEligibilityIndex(g);
+
+    // Index line boundaries so chunks can be processed independently
+    std::vector<std::pair<size_t, size_t>> lines;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t nl = data.find('\n', pos);
+        if (nl == std::string::npos) nl = data.size();
+        lines.emplace_back(pos, nl);
+        pos = nl + 1;
+    }
+
+    // Several chunks per worker so idle workers have something to steal when
+    // some ranges hold students with longer transcripts
+    const size_t chunkCount = std::min(pool.size() * 4, lines.size() / 1024 + 1);
+
+    std::vector<std::string> buffers(chunkCount);
+    std::vector<size_t> counts(chunkCount, 0);
+
+    pool.parallelFor(chunkCount, [&](size_t t) {
+        const size_t first = lines.size() * t / chunkCount;
+        const size_t last = lines.size() * (t + 1) / chunkCount;
+        std::vector<uint64_t> completed(idx.words + 1);
+        std::string studentId;
+
+        for (size_t i = first; i < last; ++i) {
+            const char* b = data.data() + lines[i].first;
+            const char* e = data.data() + lines[i].second;
+            if (parseStudentLine(g, b, e, studentId, completed)) {
+                appendEligibleCourses(g, idx, studentId, completed.data(), buffers[t]);
+                ++counts[t];
+            }
+        }
+    });
+
+    studentsOut = 0;
+    for (size_t t = 0; t < chunkCount; ++t) {
+        out.write(buffers[t].data(), static_cast<std::streamsize>(buffers[t].size()));
+        studentsOut += counts[t];
+    }
+    return static_cast<bool>(out);
+}
+
+// -----------------------------
+// Minimum-term degree planner
+// -----------------------------
+// depth[id] is the longest prerequisite chain below a course (0 = no
+// prerequisites). It is computed once per load along the CSR topological
+// order and patched by single prerequisite edits. Because a prerequisite
+// always has a smaller depth than the course that needs it, sorting by
+// depth gives a topological order for any planning request without
+// re-sorting the whole graph. Depths are paged like the CSR rows, so an
+// edit copies only the pages whose depths it changes.
+struct PlannerCache {
+    PagedArray<int> depth;
+    bool hasCycle = false;
+};
+
+static PlannerCache buildPlannerCache(const PrerequisiteGraph& g) {
+    PlannerCache cache;
+    std::vector<int> depth(g.size(), 0);
+
+    std::vector<uint32_t> order;
+    cache.hasCycle = !topologicalOrder(g, order);
+
+    for (uint32_t v : order) {
+        for (uint32_t p : g.prerequisites[v]) {
+            if (g.inCatalog(p)) {
+                depth[v] = std::max(depth[v], depth[p] + 1);
+            }
+        }
+    }
+    cache.depth = PagedArray<int>(depth);
+    return cache;
+}
+
+// Build a plan that reaches every target course in as few terms as possible,
+// taking at most maxPerTerm courses per term. Only the prerequisites the
+// student still needs are scheduled. Ready courses are picked by critical
+// path (longest chain of remaining courses that depend on them), then by
+// course number. Returns false and sets errorOut if no plan exists.
+static bool planTerms(
+    const PrerequisiteGraph& g,
+    const PlannerCache& cache,
+    const std::vector<std::string>& targets,
+    const std::vector<std::string>& completed,
+    size_t maxPerTerm,
+    VisitMarks& marks,
+    std::vector<std::vector<std::string>>& termsOut,
+    std::string& errorOut
+) {
+    termsOut.clear();
+    if (cache.hasCycle) {
+        errorOut = "Prerequisite cycle detected in catalog";
+        return false;
+    }
+    if (maxPerTerm == 0) {
+        errorOut = "Courses per term must be at least 1";
+        return false;
+    }
+
+    // Completed courses are marked up front so the closure skips them
+    marks.reset(g.size());
+    for (const auto& c : completed) {
+        const int id = g.idOf(c);
+        if (id >= 0) marks.mark(static_cast<uint32_t>(id));
+    }
+
+    // Upstream subset: everything the targets need that is not completed
+    std::vector<uint32_t> needed;
+    for (const auto& t : targets) {
+        const int id = g.idOf(t);
+        if (id < 0 || !g.inCatalog(static_cast<uint32_t>(id))) {
+            errorOut = t + " is not in the catalog";
+            return false;
+        }
+        if (marks.mark(static_cast<uint32_t>(id))) needed.push_back(static_cast<uint32_t>(id));
+    }
+    const std::vector<uint32_t> roots(needed);
+    collectClosure(g, roots, false, marks, needed);
+
+    for (uint32_t id : needed) {
+        if (!g.inCatalog(id)) {
+            errorOut = g.name(id) + " is not in the catalog";
+            return false;
+        }
+    }
+
+    // Ids are assigned in course-number order, so they break depth ties
+    std::sort(needed.begin(), needed.end(), [&](uint32_t a, uint32_t b) {
+        return cache.depth[a] != cache.depth[b] ? cache.depth[a] < cache.depth[b] : a < b;
+    });
+
+    std::unordered_map<uint32_t, size_t> pos;
+    pos.reserve(needed.size());
+    for (size_t i = 0; i < needed.size(); ++i) {
+        pos[needed[i]] = i;
+    }
+
+    // Critical-path height and remaining-prerequisite counts within the subset
+    std::vector<int> height(needed.size(), 0);
+    std::vector<size_t> waiting(needed.size(), 0);
+    std::vector<std::vector<size_t>> dependents(needed.size());
+    for (size_t i = needed.size(); i-- > 0;) {
+        const uint32_t v = needed[i];
+        for (uint32_t p : g.prerequisites[v]) {
+            const auto it = pos.find(p);
+            if (it == pos.end()) continue; // already completed
+            height[it->second] = std::max(height[it->second], height[i] + 1);
+            dependents[it->second].push_back(i);
+            ++waiting[i];
+        }
+    }
+
+    // List scheduling: fill each term with the highest-priority ready courses
+    auto lowerPriority = [&](size_t a, size_t b) {
+        if (height[a] != height[b]) return height[a] < height[b];
+        return needed[a] > needed[b];
+    };
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < needed.size(); ++i) {
+        if (waiting[i] == 0) ready.push_back(i);
+    }
+    std::make_heap(ready.begin(), ready.end(), lowerPriority);
+
+    size_t scheduled = 0;
+    std::vector<size_t> term;
+    while (!ready.empty()) {
+        term.clear();
+        while (!ready.empty() && term.size() < maxPerTerm) {
+            std::pop_heap(ready.begin(), ready.end(), lowerPriority);
+            term.push_back(ready.back());
+            ready.pop_back();
+        }
+
+        termsOut.emplace_back();
+        for (size_t i : term) {
+            termsOut.back().push_back(g.name(needed[i]));
+        }
+        std::sort(termsOut.back().begin(), termsOut.back().end());
+
+        // Courses unlocked by this term become ready next term
+        for (size_t i : term) {
+            for (size_t d : dependents[i]) {
+                if (--waiting[d] == 0) {
+                    ready.push_back(d);
+                    std::push_heap(ready.begin(), ready.end(), lowerPriority);
+                }
+            }
+        }
+        scheduled += term.size();
+    }
+
+    if (scheduled != needed.size()) {
+        errorOut = "Prerequisite cycle detected in catalog";
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------
+// Title keyword index
+// -----------------------------
+// Built once per load. Titles are split into lowercase runs of ASCII letters
+// and digits (bytes >= 0x80 stay inside words), and every term maps to the
+// ascending positions, in CatalogSnapshot::ordered, of the courses whose
+// titles contain it. Positions follow course-number order, so results come
+// out sorted with no extra work.
+//
+// Posting lists are stored in blocks of kPostingBlock positions. A block
+// keeps its first position uncompressed and the rest as varint deltas, so
+// a probe can gallop over block heads and decode a single block. Queries
+// AND their terms starting from the rarest one. While the candidates are
+// fewer than the next list's blocks, each candidate is probed by galloping;
+// otherwise the next list is decoded whole and merged, four by four with
+// SSE2 where available.
+static const uint32_t kPostingBlock = 128;
+
+struct TitleIndex {
+    std::unordered_map<std::string, uint32_t> terms;  // term -> term id
+    std::vector<uint32_t> docCount;                   // term id -> courses containing it
+    std::vector<uint32_t> blockBegin;                 // term id -> first block (size terms + 1)
+    std::vector<uint32_t> blockFirst;                 // block -> first position
+    std::vector<uint32_t> blockOffset;                // block -> offset of its deltas in bytes
+    std::vector<uint8_t> bytes;                       // varint-encoded deltas
+    std::vector<std::string> termText;                // term id -> term
+
+    // Posting storage, not counting the term dictionary
+    size_t postingBytes() const {
+        return (docCount.size() + blockBegin.size() + blockFirst.size() + blockOffset.size()) * 4
+            + bytes.size();
+    }
+};
+
+// Calls onTerm for each lowercase term of text; term is scratch space
+template <typename OnTerm>
+static void forEachTitleTerm(const std::string& text, std::string& term, OnTerm onTerm) {
+    term.clear();
+    for (char ch : text) {
+        const unsigned char u = static_cast<unsigned char>(ch);
+        if (std::isalnum(u) || u >= 0x80) {
+            term += static_cast<char>(std::tolower(u));
+        }
+        else if (!term.empty()) {
+            onTerm(term);
+            term.clear();
+        }
+    }
+    if (!term.empty()) {
+        onTerm(term);
+        term.clear();
+    }
+}
+
+static TitleIndex buildTitleIndex(const std::vector<const Course*>& ordered) {
+    TitleIndex idx;
+
+    // (term id, position) for every word of every title, positions ascending
+    std::vector<std::pair<uint32_t, uint32_t>> hits;
+    hits.reserve(ordered.size() * 4);
+    std::string term;
+    for (uint32_t pos = 0; pos < ordered.size(); ++pos) {
+        forEachTitleTerm(ordered[pos]->title, term, [&](const std::string& t) {
+            const auto id = idx.terms.emplace(t, static_cast<uint32_t>(idx.terms.size())).first->second;
+            hits.emplace_back(id, pos);
+        });
+    }
+
+    // Counting sort by term keeps positions ascending within each term
+    const size_t n = idx.terms.size();
+    std::vector<uint32_t> start(n + 1, 0);
+    for (const auto& h : hits) {
+        ++start[h.first + 1];
+    }
+    for (size_t t = 0; t < n; ++t) {
+        start[t + 1] += start[t];
+    }
+    std::vector<uint32_t> positions(hits.size());
+    std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+    for (const auto& h : hits) {
+        positions[fill[h.first]++] = h.second;
+    }
+    hits.clear();
+    hits.shrink_to_fit();
+
+    idx.termText.resize(n);
+    for (const auto& kv : idx.terms) {
+        idx.termText[kv.second] = kv.first;
+    }
+
+    idx.docCount.assign(n, 0);
+    idx.blockBegin.reserve(n + 1);
+    idx.bytes.reserve(positions.size());
+    for (uint32_t t = 0; t < n; ++t) {
+        idx.blockBegin.push_back(static_cast<uint32_t>(idx.blockFirst.size()));
+        uint32_t count = 0, prev = 0;
+        for (uint32_t i = start[t]; i < start[t + 1]; ++i) {
+            const uint32_t pos = positions[i];
+            if (count && pos == prev) continue;  // word repeated in one title
+            if (count % kPostingBlock == 0) {
+                idx.blockFirst.push_back(pos);
+                idx.blockOffset.push_back(static_cast<uint32_t>(idx.bytes.size()));
+            }
+            else {
+                for (uint32_t delta = pos - prev; ; delta >>= 7) {
+                    if (delta < 0x80) {
+                        idx.bytes.push_back(static_cast<uint8_t>(delta));
+                        break;
+                    }
+                    idx.bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+                }
+            }
+            prev = pos;
+            ++count;
+        }
+        idx.docCount[t] = count;
+    }
+    idx.blockBegin.push_back(static_cast<uint32_t>(idx.blockFirst.size()));
+
+    return idx;
+}
+
+// Decode block (an absolute block number) of a list with count positions
+// into out, replacing its contents
+static void decodePostingBlock(const TitleIndex& idx, uint32_t block, uint32_t count,
+    std::vector<uint32_t>& out) {
+    out.resize(count);
+    const uint8_t* p = idx.bytes.data() + idx.blockOffset[block];
+    uint32_t pos = idx.blockFirst[block];
+    out[0] = pos;
+    for (uint32_t i = 1; i < count; ++i) {
+        uint32_t delta = 0;
+        for (int shift = 0; ; shift += 7) {
+            const uint8_t b = *p++;
+            delta |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (b < 0x80) break;
+        }
+        pos += delta;
+        out[i] = pos;
+    }
+}
+
+// Number of positions in block k (relative to the term's first block)
+static uint32_t postingBlockSize(const TitleIndex& idx, uint32_t term, uint32_t k) {
+    return std::min(kPostingBlock, idx.docCount[term] - k * kPostingBlock);
+}
+
+static void decodePostingList(const TitleIndex& idx, uint32_t term, std::vector<uint32_t>& out,
+    std::vector<uint32_t>& block) {
+    out.clear();
+    out.reserve(idx.docCount[term]);
+    const uint32_t first = idx.blockBegin[term];
+    for (uint32_t k = 0; first + k < idx.blockBegin[term + 1]; ++k) {
+        decodePostingBlock(idx, first + k, postingBlockSize(idx, term, k), block);
+        out.insert(out.end(), block.begin(), block.end());
+    }
+}
+
+// Intersect two ascending lists into out and return the count; out may
+// alias a. The SSE2 loop compares four positions of a against all four
+// rotations of four positions of b, then advances whichever block ends
+// lower (both when they end on the same value).
+static size_t intersectSorted(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    size_t i = 0, j = 0, k = 0;
+#if defined(__SSE2__)
+    while (i + 4 <= na && j + 4 <= nb) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i eq = _mm_cmpeq_epi32(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if (mask) {
+            for (int m = 0; m < 4; ++m) {
+                if (mask & (1 << m)) out[k++] = a[i + m];
+            }
+        }
+        const uint32_t lastA = a[i + 3], lastB = b[j + 3];
+        if (lastA <= lastB) i += 4;
+        if (lastB <= lastA) j += 4;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        }
+        else if (b[j] < a[i]) {
+            ++j;
+        }
+        else {
+            out[k++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return k;
+}
+
+// Keep the candidates that appear in term's list, probing block heads by
+// galloping from the last block used. Candidates ascend, so the block
+// cursor only moves forward and each block is decoded at most once.
+static void gallopPostingList(const TitleIndex& idx, uint32_t term, std::vector<uint32_t>& candidates,
+    std::vector<uint32_t>& block) {
+    const uint32_t* heads = idx.blockFirst.data() + idx.blockBegin[term];
+    const uint32_t blocks = idx.blockBegin[term + 1] - idx.blockBegin[term];
+    uint32_t cursor = 0;
+    uint32_t decoded = blocks;  // none yet
+    size_t kept = 0;
+
+    for (const uint32_t pos : candidates) {
+        if (heads[cursor] > pos) continue;
+        uint32_t lo = cursor, hi = cursor + 1, step = 1;
+        while (hi < blocks && heads[hi] <= pos) {
+            lo = hi;
+            hi += step;
+            step <<= 1;
+        }
+        hi = std::min(hi, blocks);
+        cursor = static_cast<uint32_t>(std::upper_bound(heads + lo, heads + hi, pos) - heads) - 1;
+
+        if (decoded != cursor) {
+            decodePostingBlock(idx, idx.blockBegin[term] + cursor, postingBlockSize(idx, term, cursor), block);
+            decoded = cursor;
+        }
+        if (std::binary_search(block.begin(), block.end(), pos)) {
+            candidates[kept++] = pos;
+        }
+    }
+    candidates.resize(kept);
+}
+
+// Positions in CatalogSnapshot::ordered of the courses whose titles contain
+// every word of query, ascending. Empty when the query has no words.
+static void searchTitleIndex(const TitleIndex& idx, const std::string& query, std::vector<uint32_t>& out) {
+    out.clear();
+
+    std::vector<uint32_t> terms;
+    bool missing = false;
+    std::string term;
+    forEachTitleTerm(query, term, [&](const std::string& t) {
+        const auto it = idx.terms.find(t);
+        if (it == idx.terms.end()) missing = true;
+        else terms.push_back(it->second);
+    });
+    if (missing || terms.empty()) return;
+
+    std::sort(terms.begin(), terms.end(), [&idx](uint32_t a, uint32_t b) {
+        return std::make_pair(idx.docCount[a], a) < std::make_pair(idx.docCount[b], b);
+    });
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::vector<uint32_t> block, other;
+    decodePostingList(idx, terms[0], out, block);
+    for (size_t t = 1; t < terms.size() && !out.empty(); ++t) {
+        const uint32_t blocks = idx.blockBegin[terms[t] + 1] - idx.blockBegin[terms[t]];
+        if (out.size() < blocks) {
+            gallopPostingList(idx, terms[t], out, block);
+        }
+        else {
+            decodePostingList(idx, terms[t], other, block);
+            out.resize(intersectSorted(out.data(), out.size(), other.data(), other.size(), out.data()));
+        }
+    }
+}
+
+// -----------------------------
+// Fuzzy course lookup
+// -----------------------------
+// When a course number is not found, suggestions come from two trigram
+// indexes built with each snapshot: one over course numbers and one over
+// the title index's vocabulary. Keys are lowercased and padded with a space
+// on both ends, so "cs200" yields " cs", "cs2", "s20", "200" and "00 ".
+//
+// A lookup collects the keys sharing trigrams with the query, most shared
+// first, and ranks them by bounded Levenshtein distance computed with
+// Myers' bit-parallel algorithm (64 pattern positions per machine word).
+// Trigrams found in more than kMaxTrigramList keys carry little signal and
+// are skipped, and at most kFuzzyCandidates keys are verified. Together
+// these bound the work per lookup regardless of catalog size.
+//
+// The query is matched two ways. As a course number, it must be within
+// fuzzyDistanceLimit edits. As title words, each word is corrected to the
+// nearest vocabulary term within that limit, and the corrected words go
+// through searchTitleIndex. The distance of a title match is the sum over
+// its words.
+static const uint32_t kMaxTrigramList = 16384;
+static const size_t kFuzzyCandidates = 512;
+static const size_t kMaxSuggestions = 5;
+
+struct TrigramIndex {
+    size_t keyCount = 0;
+    std::unordered_map<uint32_t, uint32_t> slots;  // packed trigram -> slot
+    std::vector<uint32_t> offsets;                 // slot -> first entry (size slots + 1)
+    std::vector<uint32_t> keys;                    // key ids, ascending within a slot
+};
+
+// Calls onTrigram with each packed trigram of the padded, lowercased text
+template <typename OnTrigram>
+static void forEachTrigram(const std::string& text, OnTrigram onTrigram) {
+    uint32_t window = static_cast<uint32_t>(' ');
+    for (size_t i = 0; i <= text.size(); ++i) {
+        const unsigned char ch = i < text.size()
+            ? static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(text[i]))) : ' ';
+        window = ((window << 8) | ch) & 0xFFFFFF;
+        if (i >= 1) onTrigram(window);
+    }
+}
+
+// keyAt(i) returns key i as a string, for i in [0, count)
+template <typename KeyAt>
+static TrigramIndex buildTrigramIndex(size_t count, KeyAt keyAt) {
+    TrigramIndex idx;
+    idx.keyCount = count;
+
+    std::vector<std::pair<uint32_t, uint32_t>> hits;  // (slot, key id)
+    std::vector<uint32_t> seen;
+    for (uint32_t key = 0; key < count; ++key) {
+        seen.clear();
+        forEachTrigram(keyAt(key), [&](uint32_t trigram) { seen.push_back(trigram); });
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+        for (uint32_t trigram : seen) {
+            const auto slot = idx.slots.emplace(trigram, static_cast<uint32_t>(idx.slots.size())).first->second;
+            hits.emplace_back(slot, key);
+        }
+    }
+
+    const size_t n = idx.slots.size();
+    idx.offsets.assign(n + 1, 0);
+    for (const auto& h : hits) {
+        ++idx.offsets[h.first + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        idx.offsets[i + 1] += idx.offsets[i];
+    }
+    idx.keys.resize(hits.size());
+    std::vector<uint32_t> fill(idx.offsets.begin(), idx.offsets.end() - 1);
+    for (const auto& h : hits) {
+        idx.keys[fill[h.first]++] = h.second;
+    }
+    return idx;
+}
+
+// Keys sharing the most trigrams with text, at most kFuzzyCandidates,
+// ordered by key id
+static void trigramCandidates(const TrigramIndex& idx, const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+
+    std::vector<uint32_t> trigrams;
+    forEachTrigram(text, [&](uint32_t trigram) { trigrams.push_back(trigram); });
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    // Shared-trigram counts per key. The counters stay allocated per thread
+    // and only the touched entries are cleared afterwards.
+    thread_local std::vector<uint8_t> shared;
+    if (shared.size() < idx.keyCount) shared.resize(idx.keyCount);
+    std::vector<uint32_t> touched;
+    for (uint32_t trigram : trigrams) {
+        const auto it = idx.slots.find(trigram);
+        if (it == idx.slots.end()) continue;
+        const uint32_t first = idx.offsets[it->second];
+        const uint32_t last = idx.offsets[it->second + 1];
+        if (last - first > kMaxTrigramList) continue;
+        for (uint32_t e = first; e < last; ++e) {
+            const uint32_t key = idx.keys[e];
+            if (shared[key] == 0) touched.push_back(key);
+            if (shared[key] < 255) ++shared[key];
+        }
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> counted;  // (shared, key id)
+    counted.reserve(touched.size());
+    for (uint32_t key : touched) {
+        counted.emplace_back(shared[key], key);
+        shared[key] = 0;
+    }
+
+    const auto moreShared = [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    if (counted.size() > kFuzzyCandidates) {
+        std::nth_element(counted.begin(), counted.begin() + kFuzzyCandidates, counted.end(), moreShared);
+        counted.resize(kFuzzyCandidates);
+    }
+    for (const auto& c : counted) {
+        out.push_back(c.second);
+    }
+    std::sort(out.begin(), out.end());
+}
+
+// Pattern bitmasks for Myers' algorithm, matching either letter case.
+// Patterns longer than 64 bytes are cut to 64.
+struct MyersPattern {
+    std::array<uint64_t, 256> peq{};
+    uint32_t length = 0;
+
+    explicit MyersPattern(const std::string& pattern) {
+        length = static_cast<uint32_t>(std::min<size_t>(pattern.size(), 64));
+        for (uint32_t i = 0; i < length; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(pattern[i]);
+            peq[static_cast<unsigned char>(std::tolower(ch))] |= uint64_t{1} << i;
+            peq[static_cast<unsigned char>(std::toupper(ch))] |= uint64_t{1} << i;
+        }
+    }
+};
+
+// Levenshtein distance between the pattern and text, or maxDistance + 1
+// as soon as it is known to exceed maxDistance
+static uint32_t boundedLevenshtein(const MyersPattern& p, const std::string& text, uint32_t maxDistance) {
+    const uint32_t m = p.length;
+    const size_t n = text.size();
+    const size_t gap = m > n ? m - n : n - m;
+    if (gap > maxDistance) return maxDistance + 1;
+    if (m == 0) return static_cast<uint32_t>(n);
+
+    const uint64_t high = uint64_t{1} << (m - 1);
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    uint32_t score = m;
+    for (size_t j = 0; j < n; ++j) {
+        const uint64_t eq = p.peq[static_cast<unsigned char>(text[j])];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & high) ++score;
+        else if (mh & high) --score;
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // The score drops by at most one per remaining column
+        const size_t remaining = n - j - 1;
+        if (score > maxDistance + remaining) return maxDistance + 1;
+    }
+    return score <= maxDistance ? score : maxDistance + 1;
+}
+
+// Edits allowed for a query (or query word) of this length
+static uint32_t fuzzyDistanceLimit(size_t length) {
+    return length <= 4 ? 1 : 2;
+}
+
+struct CourseSuggestion {
+    uint32_t position;  // in CatalogSnapshot::ordered
+    uint32_t distance;
+};
+
+// -----------------------------
+// Prefix completion
+// -----------------------------
+// Suggestions for a partly typed query. They are built with each snapshot,
+// so a reload swaps them in atomically along with everything else.
+//
+// Course numbers complete against CatalogSnapshot::ordered, which is
+// already sorted: a binary search finds the first number with the prefix
+// and the next k are returned in order. Title words live in a sorted array
+// of the title index's terms. The words with the prefix form one range, and
+// a sparse table of range maxima over course counts pulls out the k most
+// common of them in O(k log k) without scanning the range.
+static const size_t kCompletionLimit = 8;
+
+struct PrefixIndex {
+    std::vector<uint32_t> terms;                // title term ids sorted by text
+    std::vector<std::vector<uint32_t>> widest;  // [l][i]: slot of the most common term in [i, i + 2^l)
+};
+
+static PrefixIndex buildPrefixIndex(const TitleIndex& titles) {
+    PrefixIndex idx;
+    const size_t n = titles.termText.size();
+    idx.terms.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        idx.terms[i] = i;
+    }
+    std::sort(idx.terms.begin(), idx.terms.end(), [&titles](uint32_t a, uint32_t b) {
+        return titles.termText[a] < titles.termText[b];
+    });
+
+    // Ties go to the earlier slot, so equally common words come out sorted
+    auto wider = [&](uint32_t a, uint32_t b) {
+        return titles.docCount[idx.terms[b]] > titles.docCount[idx.terms[a]] ? b : a;
+    };
+    if (n == 0) return idx;
+    idx.widest.emplace_back(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        idx.widest[0][i] = i;
+    }
+    for (size_t half = 1; half * 2 <= n; half *= 2) {
+        const std::vector<uint32_t>& below = idx.widest.back();
+        std::vector<uint32_t> level(n - half * 2 + 1);
+        for (size_t i = 0; i < level.size(); ++i) {
+            level[i] = wider(below[i], below[i + half]);
+        }
+        idx.widest.push_back(std::move(level));
+    }
+    return idx;
+}
+
+static bool hasPrefix(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Up to limit catalog courses whose numbers start with prefix (already
+// normalized), in course-number order
+static void completeCourseNumbers(const std::vector<const Course*>& ordered, const std::string& prefix,
+    size_t limit, std::vector<const Course*>& out) {
+    out.clear();
+    auto it = std::lower_bound(ordered.begin(), ordered.end(), prefix,
+        [](const Course* c, const std::string& p) { return c->courseNumber < p; });
+    for (; it != ordered.end() && out.size() < limit && hasPrefix((*it)->courseNumber, prefix); ++it) {
+        out.push_back(*it);
+    }
+}
+
+// Up to limit title term ids starting with prefix (lowercase), most
+// common first
+static void completeTitleWords(const TitleIndex& titles, const PrefixIndex& idx, const std::string& prefix,
+    size_t limit, std::vector<uint32_t>& out) {
+    out.clear();
+    const auto& text = titles.termText;
+    const auto first = std::lower_bound(idx.terms.begin(), idx.terms.end(), prefix,
+        [&text](uint32_t t, const std::string& p) { return text[t] < p; });
+    const auto last = std::partition_point(first, idx.terms.end(),
+        [&](uint32_t t) { return hasPrefix(text[t], prefix); });
+    if (first == last) return;
+
+    auto widestIn = [&](size_t lo, size_t hi) {
+        size_t level = 0;
+        while ((size_t{2} << level) <= hi - lo) ++level;
+        const uint32_t a = idx.widest[level][lo];
+        const uint32_t b = idx.widest[level][hi - (size_t{1} << level)];
+        return titles.docCount[idx.terms[b]] > titles.docCount[idx.terms[a]] ? b : a;
+    };
+
+    // Heap of ranges keyed by their most common slot: take the top one,
+    // then split its range around that slot
+    struct Range {
+        size_t lo, hi;
+        uint32_t slot;
+    };
+    auto lessCommon = [&](const Range& a, const Range& b) {
+        const uint32_t ca = titles.docCount[idx.terms[a.slot]], cb = titles.docCount[idx.terms[b.slot]];
+        return ca != cb ? ca < cb : a.slot > b.slot;
+    };
+    std::vector<Range> heap;
+    auto push = [&](size_t lo, size_t hi) {
+        if (lo >= hi) return;
+        heap.push_back({ lo, hi, widestIn(lo, hi) });
+        std::push_heap(heap.begin(), heap.end(), lessCommon);
+    };
+
+    push(static_cast<size_t>(first - idx.terms.begin()), static_cast<size_t>(last - idx.terms.begin()));
+    while (!heap.empty() && out.size() < limit) {
+        std::pop_heap(heap.begin(), heap.end(), lessCommon);
+        const Range top = heap.back();
+        heap.pop_back();
+        out.push_back(idx.terms[top.slot]);
+        push(top.lo, top.slot);
+        push(top.slot + 1, top.hi);
+    }
+}
+
+// -----------------------------
+// Catalog snapshots (RCU)
+// -----------------------------
+// Everything built from one load (the course map, CSR and planner cache) is
+// bundled into an immutable snapshot. Readers pin the current snapshot
+// without taking a lock; a reload builds a new snapshot off to the side and
+// publishes it with one atomic pointer swap.
+//
+// A prerequisite edit publishes a new snapshot the same way, but builds it
+// by copying the current one: the parts no edit can change sit in a shared
+// LoadedCatalog, the graph and planner depths are paged copy-on-write, and
+// edited course records are kept apart from the loaded ones. The copy is a
+// few hundred pointers, and the edit then rewrites a handful of pages.
+//
+// Reclamation is epoch based. Each reader thread owns a slot and, while it
+// holds a snapshot, records the global epoch it entered in. Publishing
+// bumps the epoch and retires the old snapshot tagged with the new epoch.
+// A retired snapshot is freed once every active slot shows that epoch or a
+// later one, because any reader that can still see it entered earlier.
+// Built once per load and shared by every snapshot edits derive from it.
+// Nothing here depends on prerequisites except the loaded course records,
+// which CatalogSnapshot::current maps to their edited versions.
+struct LoadedCatalog {
+    std::unordered_map<std::string, Course> courses;
+    std::vector<const Course*> ordered;  // catalog courses by course number
+    TitleIndex titles;                   // positions refer to ordered
+    TrigramIndex numberTrigrams;         // key ids are positions in ordered
+    TrigramIndex termTrigrams;           // key ids are title term ids
+    PrefixIndex completions;             // over titles' terms
+
+    // The full "number, title" listing, rendered on first use and reused
+    // after that. A reload builds a new LoadedCatalog that starts without
+    // one, and edits never change a number or title; nothing needs
+    // invalidating.
+    const std::string& sortedListing() const {
+        std::call_once(listingOnce, [this]() {
+            size_t bytes = 0;
+            for (const Course* c : ordered) {
+                bytes += c->courseNumber.size() + c->title.size() + 3;
+            }
+            listing.reserve(bytes);
+            for (const Course* c : ordered) {
+                listing += c->courseNumber;
+                listing += ", ";
+                listing += c->title;
+                listing += '\n';
+            }
+        });
+        return listing;
+    }
+
+private:
+    mutable std::once_flag listingOnce;
+    mutable std::string listing;
+};
+
+// Course records replaced by prerequisite edits, by graph id. Paged like
+// PagedArray, except that a page is only allocated by its first edit.
+class EditedCourses {
+public:
+    bool empty() const { return pages.empty(); }
+
+    const Course* find(uint32_t id) const {
+        const size_t page = id / kRowsPerPage;
+        if (page >= pages.size() || !pages[page]) return nullptr;
+        return (*pages[page])[id % kRowsPerPage].get();
+    }
+
+    void set(uint32_t id, Course course) {
+        const size_t page = id / kRowsPerPage;
+        if (page >= pages.size()) pages.resize(page + 1);
+        std::shared_ptr<Page>& p = pages[page];
+        if (!p) p = std::make_shared<Page>(kRowsPerPage);
+        else if (p.use_count() != 1) p = std::make_shared<Page>(*p);
+        (*p)[id % kRowsPerPage] = std::make_shared<const Course>(std::move(course));
+    }
+
+private:
+    using Page = std::vector<std::shared_ptr<const Course>>;
+    std::vector<std::shared_ptr<Page>> pages;
+};
+
+struct CatalogSnapshot {
+    std::shared_ptr<const LoadedCatalog> loaded;
+    EditedCourses edited;  // courses whose prerequisites changed since the load
+    PrerequisiteGraph graph;
+    PlannerCache planner;
+
+    // The current record for a course number, or nullptr
+    const Course* findCourse(const std::string& courseNumber) const {
+        if (const Course* c = editedCourse(courseNumber)) return c;
+        const auto it = loaded->courses.find(courseNumber);
+        return it == loaded->courses.end() ? nullptr : &it->second;
+    }
+
+    // The current record for a course from loaded (ordered or courses).
+    // Only prerequisites can differ, so callers that read the number and
+    // title alone can skip this.
+    const Course& current(const Course& c) const {
+        const Course* e = editedCourse(c.courseNumber);
+        return e ? *e : c;
+    }
+
+private:
+    const Course* editedCourse(const std::string& courseNumber) const {
+        if (edited.empty()) return nullptr;
+        const int id = graph.idOf(courseNumber);
+        return id < 0 ? nullptr : edited.find(static_cast<uint32_t>(id));
+    }
+};
+
+static std::unique_ptr<CatalogSnapshot> buildCatalogSnapshot(
+    std::unordered_map<std::string, Course> courses
+) {
+    auto loaded = std::make_shared<LoadedCatalog>();
+    auto snapshot = std::make_unique<CatalogSnapshot>();
+    loaded->courses = std::move(courses);
+    snapshot->graph = buildPrerequisiteGraph(loaded->courses, &loaded->ordered);
+    snapshot->planner = buildPlannerCache(snapshot->graph);
+    loaded->titles = buildTitleIndex(loaded->ordered);
+    const auto& ordered = loaded->ordered;
+    loaded->numberTrigrams = buildTrigramIndex(ordered.size(),
+        [&ordered](size_t i) -> const std::string& { return ordered[i]->courseNumber; });
+    const auto& terms = loaded->titles.termText;
+    loaded->termTrigrams = buildTrigramIndex(terms.size(),
+        [&terms](size_t i) -> const std::string& { return terms[i]; });
+    loaded->completions = buildPrefixIndex(loaded->titles);
+    snapshot->loaded = std::move(loaded);
+    return snapshot;
+}
+
+// Completions for a partly typed query, in a fixed text form: course
+// numbers starting with the whole query, then the most common title words
+// starting with its last word (none if the query ends between words)
+static void appendCompletions(const CatalogSnapshot& snap, const std::string& query, std::string& out) {
+    std::vector<const Course*> courses;
+    const std::string number = toUpper(trim(query));
+    if (!number.empty()) {
+        completeCourseNumbers(snap.loaded->ordered, number, kCompletionLimit, courses);
+    }
+    for (const Course* c : courses) {
+        out += c->courseNumber;
+        out += ", ";
+        out += c->title;
+        out += '\n';
+    }
+
+    std::string word, term;
+    forEachTitleTerm(query, term, [&word](const std::string& t) { word = t; });
+    const unsigned char last = query.empty() ? ' ' : static_cast<unsigned char>(query.back());
+    if (word.empty() || !(std::isalnum(last) || last >= 0x80)) return;
+
+    std::vector<uint32_t> words;
+    completeTitleWords(snap.loaded->titles, snap.loaded->completions, word, kCompletionLimit, words);
+    for (uint32_t t : words) {
+        out += snap.loaded->titles.termText[t];
+        const uint32_t n = snap.loaded->titles.docCount[t];
+        out += " (" + std::to_string(n) + (n == 1 ? " course)\n" : " courses)\n");
+    }
+}
+
+// Courses close to a course number that was not found, nearest first (ties
+// in course-number order), at most kMaxSuggestions
+static void suggestCourses(const CatalogSnapshot& snap, const std::string& query,
+    std::vector<CourseSuggestion>& out) {
+    out.clear();
+    const std::string text = trim(query);
+    if (text.empty()) return;
+
+    std::vector<uint32_t> candidates;
+    std::vector<CourseSuggestion> found;
+
+    // As a course number
+    const uint32_t limit = fuzzyDistanceLimit(text.size());
+    const MyersPattern number(text);
+    trigramCandidates(snap.loaded->numberTrigrams, text, candidates);
+    for (uint32_t pos : candidates) {
+        const uint32_t d = boundedLevenshtein(number, snap.loaded->ordered[pos]->courseNumber, limit);
+        if (d <= limit) found.push_back({ pos, d });
+    }
+
+    // As title words, each corrected to its nearest term
+    std::string corrected;
+    uint32_t wordsDistance = 0;
+    bool allWords = true;
+    std::string term;
+    forEachTitleTerm(text, term, [&](const std::string& word) {
+        if (!allWords) return;
+        const auto exact = snap.loaded->titles.terms.find(word);
+        if (exact != snap.loaded->titles.terms.end()) {
+            corrected += word + ' ';
+            return;
+        }
+
+        const uint32_t wordLimit = fuzzyDistanceLimit(word.size());
+        const MyersPattern pattern(word);
+        uint32_t best = wordLimit + 1, bestTerm = 0;
+        trigramCandidates(snap.loaded->termTrigrams, word, candidates);
+        for (uint32_t id : candidates) {
+            const uint32_t d = boundedLevenshtein(pattern, snap.loaded->titles.termText[id], wordLimit);
+            if (d < best || (d == best && snap.loaded->titles.docCount[id] > snap.loaded->titles.docCount[bestTerm])) {
+                best = d;
+                bestTerm = id;
+            }
+        }
+        if (best > wordLimit) {
+            allWords = false;
+            return;
+        }
+        corrected += snap.loaded->titles.termText[bestTerm] + ' ';
+        wordsDistance += best;
+    });
+    if (allWords && !corrected.empty()) {
+        searchTitleIndex(snap.loaded->titles, corrected, candidates);
+        for (uint32_t pos : candidates) {
+            found.push_back({ pos, wordsDistance });
+        }
+    }
+
+    // Keep each course once, at its smaller distance
+    std::sort(found.begin(), found.end(), [](const CourseSuggestion& a, const CourseSuggestion& b) {
+        return a.position != b.position ? a.position < b.position : a.distance < b.distance;
+    });
+    found.erase(std::unique(found.begin(), found.end(), [](const CourseSuggestion& a, const CourseSuggestion& b) {
+        return a.position == b.position;
+    }), found.end());
+
+    const size_t keep = std::min(found.size(), kMaxSuggestions);
+    std::partial_sort(found.begin(), found.begin() + keep, found.end(),
+        [](const CourseSuggestion& a, const CourseSuggestion& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.position < b.position;
+        });
+    out.assign(found.begin(), found.begin() + keep);
+}
+
+static void printCourseSuggestions(const CatalogSnapshot& snap, const std::string& query) {
+    std::vector<CourseSuggestion> suggestions;
+    suggestCourses(snap, query, suggestions);
+    if (suggestions.empty()) return;
+
+    std::cout << "Did you mean:\n";
+    for (const CourseSuggestion& s : suggestions) {
+        const Course& c = *snap.loaded->ordered[s.position];
+        std::cout << "  " << c.courseNumber << ", " << c.title << '\n';
+    }
+}
+
+// Print a sorted list of courses (sorted by course number)
+static void printCourseList(const CatalogSnapshot& snap) {
+    OutputBuffer out;
+    out.append(snap.loaded->sortedListing());
+}
+
+class CatalogHolder {
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{ 0 };  // 0 = not reading
+        uint32_t depth = 0;                // nesting, touched only by the owner
+    };
+
+public:
+    // Reader threads that may hold snapshots at the same time. A thread
+    // beyond this limit waits for another reader thread to exit.
+    static constexpr size_t kMaxReaders = 256;
+
+    class ReadGuard {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept : slot(other.slot), snapshot(other.snapshot) {
+            other.slot = nullptr;
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard() {
+            if (slot && --slot->depth == 0) {
+                slot->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        const CatalogSnapshot* get() const { return snapshot; }
+        const CatalogSnapshot* operator->() const { return snapshot; }
+        const CatalogSnapshot& operator*() const { return *snapshot; }
+        explicit operator bool() const { return snapshot != nullptr; }
+
+    private:
+        friend class CatalogHolder;
+        ReadGuard(Slot* s, const CatalogSnapshot* snap) : slot(s), snapshot(snap) {}
+
+        Slot* slot;
+        const CatalogSnapshot* snapshot;
+    };
+
+    CatalogHolder() = default;
+    CatalogHolder(const CatalogHolder&) = delete;
+    CatalogHolder& operator=(const CatalogHolder&) = delete;
+
+    // Must only be destroyed once no reader holds a snapshot
+    ~CatalogHolder() {
+        delete current.load();
+        for (const auto& r : retired) {
+            delete r.first;
+        }
+    }
+
+    // Pin the current snapshot. Wait-free apart from first use on a thread.
+    // Guards may nest on one thread.
+    ReadGuard read() const {
+        Slot& s = slots[readerIndex()];
+        if (s.depth++ == 0) {
+            s.epoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+        return ReadGuard(&s, current.load(std::memory_order_seq_cst));
+    }
+
+    // Replace the current snapshot. The previous one is freed as soon as
+    // the last reader that could see it has left.
+    void publish(std::unique_ptr<CatalogSnapshot> next) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const CatalogSnapshot* old = current.exchange(next.release(), std::memory_order_seq_cst);
+        const uint64_t retireEpoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        if (old) {
+            retired.emplace_back(old, retireEpoch);
+        }
+        reclaimLocked();
+    }
+
+    // Free retired snapshots that no reader can still see.
+    // Returns how many remain retired.
+    size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        return reclaimLocked();
+    }
+
+private:
+    mutable Slot slots[kMaxReaders];
+    std::atomic<uint64_t> globalEpoch{ 1 };
+    std::atomic<const CatalogSnapshot*> current{ nullptr };
+    std::mutex writerMutex;
+    std::vector<std::pair<const CatalogSnapshot*, uint64_t>> retired;
+
+    // Each thread claims one slot index for its lifetime, shared by all
+    // holders, and gives it back when the thread exits.
+    static size_t readerIndex() {
+        static std::atomic<bool> claimed[kMaxReaders];
+
+        struct Claim {
+            size_t index = 0;
+            Claim() {
+                while (true) {
+                    for (size_t i = 0; i < kMaxReaders; ++i) {
+                        if (!claimed[i].exchange(true, std::memory_order_acquire)) {
+                            index = i;
+                            return;
+                        }
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            ~Claim() { claimed[index].store(false, std::memory_order_release); }
+        };
+
+        thread_local Claim claim;
+        return claim.index;
+    }
+
+    size_t reclaimLocked() {
+        uint64_t oldestActive = std::numeric_limits<uint64_t>::max();
+        for (const Slot& s : slots) {
+            const uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+            if (e != 0) oldestActive = std::min(oldestActive, e);
+        }
+
+        size_t kept = 0;
+        for (const auto& r : retired) {
+            if (r.second <= oldestActive) {
+                delete r.first;
+            }
+            else {
+                retired[kept++] = r;
+            }
+        }
+        retired.resize(kept);
+        return kept;
+    }
+};
+
+// -----------------------------
+// Prerequisite edits
+// -----------------------------
+// One added or removed prerequisite changes a single forward CSR row, a
+// single reverse row, and the planner depths of the edited course and
+// the courses above it. The edit copies the current snapshot, which shares
+// every page with it, and rewrites those rows and depths in the copy; the
+// title, trigram and prefix indexes and the listing never depend on
+// prerequisites and stay shared. Depths are recomputed in the dynamic
+// topological order, so each course is visited after every prerequisite
+// whose depth moved, and propagation stops where a depth comes out
+// unchanged. Only the courses the worklist reaches are marked.
+//
+// A prerequisite the graph has no id for would break the course-number
+// order of ids, so that edit returns nullptr and the caller rebuilds. A
+// removal can leave a prerequisite-only course number without edges; it
+// keeps its id until the next rebuild.
+static std::unique_ptr<CatalogSnapshot> patchPrerequisiteEdge(const CatalogSnapshot& snap,
+    const DynamicTopoOrder& topo, VisitMarks& marks,
+    const std::string& course, const std::string& prereq, bool add) {
+    const Course* before = snap.findCourse(course);
+    const int cId = snap.graph.idOf(course);
+    const int pId = snap.graph.idOf(prereq);
+    if (!before || cId < 0) return nullptr;
+
+    auto next = std::make_unique<CatalogSnapshot>(snap);
+    const auto& list = before->prerequisites;
+    const bool present = std::find(list.begin(), list.end(), prereq) != list.end();
+    if (add == present) return next;  // nothing to change
+    if (pId < 0) return nullptr;
+
+    Course edited = *before;
+    PrerequisiteGraph& g = next->graph;
+    const uint32_t c = static_cast<uint32_t>(cId);
+    const uint32_t p = static_cast<uint32_t>(pId);
+    if (add) {
+        // Same layout a rebuild produces: forward rows follow the course's
+        // list, reverse rows are in id order
+        edited.prerequisites.push_back(prereq);
+        g.prerequisites.insert(c, g.prerequisites[c].size(), p);
+        const IdRow rev = g.dependents[p];
+        g.dependents.insert(p, static_cast<size_t>(std::upper_bound(rev.begin(), rev.end(), c) - rev.begin()), c);
+    }
+    else {
+        auto& prereqs = edited.prerequisites;
+        prereqs.erase(std::remove(prereqs.begin(), prereqs.end(), prereq), prereqs.end());
+        g.prerequisites.erase(c, p);
+        g.dependents.erase(p, c);
+    }
+    next->edited.set(c, std::move(edited));
+
+    // (position, id) min-heap: earliest in the topological order first
+    std::vector<std::pair<uint32_t, uint32_t>> queue{ { topo.position(c), c } };
+    PagedArray<int>& depth = next->planner.depth;
+    marks.reset(g.size());
+    marks.mark(c);
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+        const uint32_t v = queue.back().second;
+        queue.pop_back();
+
+        int d = 0;
+        for (uint32_t t : g.prerequisites[v]) {
+            if (g.inCatalog(t)) d = std::max(d, depth[t] + 1);
+        }
+        if (d == depth[v]) continue;
+        depth.set(v, d);
+
+        for (uint32_t w : g.dependents[v]) {
+            if (marks.mark(w)) {
+                queue.emplace_back(topo.position(w), w);
+                std::push_heap(queue.begin(), queue.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+            }
+        }
+    }
+    return next;
+}
+
+// The course map a rebuild of snap starts from: the loaded courses with
+// every edit applied
+static std::unordered_map<std::string, Course> currentCourses(const CatalogSnapshot& snap) {
+    std::unordered_map<std::string, Course> courses = snap.loaded->courses;
+    if (!snap.edited.empty()) {
+        for (uint32_t id = 0; id < snap.graph.size(); ++id) {
+            if (const Course* c = snap.edited.find(id)) courses[c->courseNumber] = *c;
+        }
+    }
+    return courses;
+}
+
+// -----------------------------
+// JSON export
+// -----------------------------
+// Streams the catalog as JSON or NDJSON straight into an OutputBuffer
+// backed by the target file. Each course becomes
+//   {"courseNumber":"CS310","title":"...","prerequisites":["CS200","CS210"]}
+// Escape action per byte: 0 copies the byte as-is, 'u' writes \u00XX, and
+// anything else is the letter after the backslash. Bytes >= 0x80 pass
+// through, so UTF-8 titles are emitted unchanged.
+static const std::array<char, 256> kJsonEscape = []() {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = 'u';
+    }
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+}();
+
+// True if any of the 8 bytes in w is a control byte, '"' or '\\'
+static bool jsonEscapeInWord(uint64_t w) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    const uint64_t quote = w ^ (ones * '"');
+    const uint64_t backslash = w ^ (ones * '\\');
+    return (((w - ones * 0x20) & ~w) | ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash)) & highs;
+}
+
+// Quote and escape a string straight into the output buffer. Clean 8-byte
+// blocks are copied whole; only blocks holding a byte to escape are walked
+// byte by byte.
+static void appendJsonString(OutputBuffer& out, const char* s, size_t n) {
+    static const char kHex[] = "0123456789abcdef";
+
+    char* const start = out.reserve(n * 6 + 2);
+    if (!start) {
+        // Longer than the whole buffer: escape one byte at a time
+        out.append('"');
+        for (size_t i = 0; i < n; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(s[i]);
+            const char esc = kJsonEscape[ch];
+            if (esc == 0) {
+                out.append(s[i]);
+            }
+            else if (esc == 'u') {
+                const char hex[6] = { '\\', 'u', '0', '0', kHex[ch >> 4], kHex[ch & 0xF] };
+                out.append(hex, sizeof(hex));
+            }
+            else {
+                const char pair[2] = { '\\', esc };
+                out.append(pair, sizeof(pair));
+            }
+        }
+        out.append('"');
+        return;
+    }
+
+    char* p = start;
+    *p++ = '"';
+    size_t i = 0;
+    while (i < n) {
+        if (i + 8 <= n) {
+            uint64_t w;
+            std::memcpy(&w, s + i, 8);
+            if (!jsonEscapeInWord(w)) {
+                std::memcpy(p, s + i, 8);
+                p += 8;
+                i += 8;
+                continue;
+            }
+        }
+        const size_t blockEnd = std::min(n, i + 8);
+        for (; i < blockEnd; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(s[i]);
+            const char esc = kJsonEscape[ch];
+            if (esc == 0) {
+                *p++ = s[i];
+            }
+            else if (esc == 'u') {
+                *p++ = '\\';
+                *p++ = 'u';
+                *p++ = '0';
+                *p++ = '0';
+                *p++ = kHex[ch >> 4];
+                *p++ = kHex[ch & 0xF];
+            }
+            else {
+                *p++ = '\\';
+                *p++ = esc;
+            }
+        }
+    }
+    *p++ = '"';
+    out.commit(static_cast<size_t>(p - start));
+}
+
+// Frames courses as either one JSON document
+//   {"courses":[{...},{...}],"count":N}
+// or NDJSON, one course object per line. Courses are written as they are
+// visited; nothing is collected first.
+class JsonCatalogWriter {
+public:
+    JsonCatalogWriter(OutputBuffer& out, bool ndjson) : out(out), ndjson(ndjson) {
+        if (!ndjson) out.append("{\"courses\":[", 12);
+    }
+
+    void beginCourse(const char* number, size_t numberLen, const char* title, size_t titleLen) {
+        if (!ndjson && written > 0) out.append(',');
+        if (!ndjson) out.append('\n');
+        out.append("{\"courseNumber\":", 16);
+        appendJsonString(out, number, numberLen);
+        out.append(",\"title\":", 9);
+        appendJsonString(out, title, titleLen);
+        out.append(",\"prerequisites\":[", 18);
+        prereqs = 0;
+    }
+
+    void prerequisite(const char* number, size_t numberLen) {
+        if (prereqs++ > 0) out.append(',');
+        appendJsonString(out, number, numberLen);
+    }
+
+    void endCourse() {
+        out.append("]}", 2);
+        if (ndjson) out.append('\n');
+        ++written;
+    }
+
+    void course(const Course& c) {
+        beginCourse(c.courseNumber.data(), c.courseNumber.size(), c.title.data(), c.title.size());
+        for (const auto& p : c.prerequisites) {
+            prerequisite(p.data(), p.size());
+        }
+        endCourse();
+    }
+
+    // Close the document and flush. Returns false if any write failed.
+    bool finish() {
+        if (!ndjson) {
+            out.append("\n],\"count\":", 11);
+            out.appendUnsigned(written);
+            out.append("}\n", 2);
+        }
+        return out.flush();
+    }
+
+    size_t count() const { return written; }
+
+private:
+    OutputBuffer& out;
+    bool ndjson;
+    size_t written = 0;
+    size_t prereqs = 0;
+};
+
+// Write every catalog course, sorted by number, to path
+static bool exportCatalogJson(const CatalogSnapshot& snap, const std::string& path, bool ndjson,
+    size_t& countOut) {
+    OutputBuffer out(path);
+    if (!out.isOpen()) {
+        return false;
+    }
+
+    JsonCatalogWriter writer(out, ndjson);
+    for (const Course* c : snap.loaded->ordered) {
+        writer.course(snap.current(*c));
+    }
+    countOut = writer.count();
+    return writer.finish();
+}
+
+// -----------------------------
+// Query server
+// -----------------------------
+// Run with: artifact1 --serve <socketPath> <csvFile>
+// Loads the catalog once and answers requests over a Unix domain socket.
+// One request per line; responses come back in request order:
+//   GET <course>          course number, title and prerequisites
+//   LIST                  every course, sorted by number
+//   RANGE <from> <to>     courses with from <= number <= to, sorted
+//   CLOSURE <course>      every direct and indirect prerequisite
+//   SEARCH <words>        courses whose titles contain every word, sorted
+//   COMPLETE <prefix>     course numbers and title words starting with prefix
+//   STATS                 work-stealing pool queue depths and steal counts
+// A response is "OK <length>\n" followed by exactly <length> body bytes, or
+// "ERR <message>\n". Clients may pipeline. The event loop only does I/O:
+// each request runs as a task on a WorkStealingPool, point lookups as
+// urgent tasks and listings as bulk tasks that split across workers. Each
+// task pins its own snapshot; responses are still sent in request order.
+#if defined(__linux__)
+
+static void appendCourseLine(const Course& c, std::string& out) {
+    out += c.courseNumber;
+    out += ", ";
+    out += c.title;
+    out += '\n';
+}
+
+static void appendFrameHeader(size_t bodySize, std::string& out) {
+    out += "OK ";
+    out += std::to_string(bodySize);
+    out += '\n';
+}
+
+static void appendFramed(const std::string& body, std::string& out) {
+    appendFrameHeader(body.size(), out);
+    out += body;
+}
+
+// A response slot filled in by a pool task. Connections keep their slots
+// in request order and only send a response once every earlier one is done.
+// A LIST body is not copied: out holds the frame header, and shared points
+// at the catalog's rendered listing, keeping the loaded catalog alive until
+// the connection has sent it.
+struct PendingResponse {
+    std::string out;
+    std::shared_ptr<const std::string> shared;
+    std::atomic<bool> done{ false };
+
+    size_t size() const { return out.size() + (shared ? shared->size() : 0); }
+};
+
+// Listings at least this long are rendered in parallel chunks
+static const size_t kListingChunk = 4096;
+
+// Render the catalog courses whose ids fall in [first, last). CSR ids are
+// assigned in course-number order, so this is already sorted. Long ranges
+// are split into chunks rendered across the pool and joined in order.
+static void renderListing(const CatalogSnapshot& snap, size_t first, size_t last,
+    WorkStealingPool& pool, std::string& body) {
+    const PrerequisiteGraph& g = snap.graph;
+    auto renderRange = [&](size_t from, size_t to, std::string& out) {
+        for (size_t id = from; id < to; ++id) {
+            if (g.inCatalog(static_cast<uint32_t>(id))) {
+                appendCourseLine(snap.loaded->courses.at(g.name(static_cast<uint32_t>(id))), out);
+            }
+        }
+    };
+
+    const size_t count = last - first;
+    if (count < kListingChunk * 2) {
+        renderRange(first, last, body);
+        return;
+    }
+
+    const size_t chunks = (count + kListingChunk - 1) / kListingChunk;
+    std::vector<std::string> parts(chunks);
+    pool.parallelFor(chunks, [&](size_t i) {
+        const size_t from = first + i * kListingChunk;
+        renderRange(from, std::min(last, from + kListingChunk), parts[i]);
+    });
+
+    size_t total = 0;
+    for (const auto& p : parts) total += p.size();
+    body.reserve(body.size() + total);
+    for (const auto& p : parts) body += p;
+}
+
+// Fill in the response to a single request line. Runs on a pool worker;
+// bulk requests may fan out to other workers through the pool.
+static void executeQuery(const CatalogSnapshot& snap, const std::string& request,
+    WorkStealingPool& pool, PendingResponse& response) {
+    thread_local VisitMarks marks;
+    std::string& out = response.out;
+
+    std::istringstream ss(request);
+    std::string command, arg1, arg2;
+    ss >> command >> arg1 >> arg2;
+    command = toUpper(command);
+    arg1 = toUpper(arg1);
+    arg2 = toUpper(arg2);
+
+    const PrerequisiteGraph& g = snap.graph;
+    std::string body;
+
+    if (command == "GET" && !arg1.empty()) {
+        const Course* found = snap.findCourse(arg1);
+        if (!found) {
+            std::vector<CourseSuggestion> suggestions;
+            suggestCourses(snap, arg1, suggestions);
+            out += "ERR Course not found";
+            for (size_t i = 0; i < suggestions.size(); ++i) {
+                out += i ? ", " : "; did you mean ";
+                out += snap.loaded->ordered[suggestions[i].position]->courseNumber;
+            }
+            out += '\n';
+            return;
+        }
+        const Course& c = *found;
+        appendCourseLine(c, body);
+        body += "Prerequisites: ";
+        if (c.prerequisites.empty()) body += "None";
+        for (size_t i = 0; i < c.prerequisites.size(); ++i) {
+            if (i) body += ", ";
+            body += c.prerequisites[i];
+        }
+        body += '\n';
+    }
+    else if (command == "LIST") {
+        // Aliases the listing while owning the catalog it lives in
+        response.shared = std::shared_ptr<const std::string>(snap.loaded, &snap.loaded->sortedListing());
+        appendFrameHeader(response.shared->size(), out);
+        return;
+    }
+    else if (command == "RANGE" && !arg2.empty()) {
+        const std::vector<std::string>& names = g.keys->names;
+        const auto first = std::lower_bound(names.begin(), names.end(), arg1);
+        const auto last = std::upper_bound(names.begin(), names.end(), arg2);
+        if (first < last) {
+            renderListing(snap, static_cast<size_t>(first - names.begin()),
+                static_cast<size_t>(last - names.begin()), pool, body);
+        }
+    }
+    else if (command == "CLOSURE" && !arg1.empty()) {
+        const int id = g.idOf(arg1);
+        if (id < 0 || !g.inCatalog(static_cast<uint32_t>(id))) {
+            out += "ERR Course not found\n";
+            return;
+        }
+        std::vector<uint32_t> ids;
+        marks.reset(g.size());
+        marks.mark(static_cast<uint32_t>(id));
+        collectClosure(g, { static_cast<uint32_t>(id) }, false, marks, ids);
+        std::sort(ids.begin(), ids.end());
+        for (uint32_t p : ids) {
+            body += g.name(p);
+            body += '\n';
+        }
+    }
+    else if (command == "SEARCH" && !arg1.empty()) {
+        const size_t words = request.find_first_not_of(" \t") + command.size();
+        std::vector<uint32_t> matches;
+        searchTitleIndex(snap.loaded->titles, request.substr(words), matches);
+        for (uint32_t pos : matches) {
+            appendCourseLine(*snap.loaded->ordered[pos], body);
+        }
+    }
+    else if (command == "COMPLETE" && !arg1.empty()) {
+        const size_t prefix = request.find_first_not_of(" \t", request.find_first_not_of(" \t") + command.size());
+        appendCompletions(snap, request.substr(prefix), body);
+    }
+    else if (command == "STATS") {
+        body += "urgent depth " + std::to_string(pool.urgentDepth()) + "\n";
+        const auto stats = pool.stats();
+        for (size_t i = 0; i < stats.size(); ++i) {
+            body += "worker " + std::to_string(i) + " depth " + std::to_string(stats[i].depth) +
+                " executed " + std::to_string(stats[i].executed) +
+                " steals " + std::to_string(stats[i].steals) + "\n";
+        }
+    }
+    else {
+        out += "ERR Unknown request\n";
+        return;
+    }
+
+    appendFramed(body, out);
+}
+
+// Hand one request to the pool. Point lookups are urgent; listings are bulk
+// work that can be split. complete() is called once the slot is filled.
+static void dispatchQuery(WorkStealingPool& pool, const CatalogHolder& catalog,
+    const std::string& request, std::shared_ptr<PendingResponse> slot,
+    std::function<void()> complete) {
+    std::string command = request.substr(0, request.find(' '));
+    command = toUpper(command);
+    const bool bulk = command == "LIST" || command == "RANGE";
+
+    auto task = [&pool, &catalog, request, slot, complete]() {
+        const auto snap = catalog.read();
+        if (snap) executeQuery(*snap, request, pool, *slot);
+        else slot->out += "ERR No catalog loaded\n";
+        slot->done.store(true, std::memory_order_release);
+        complete();
+    };
+    if (bulk) pool.submit(std::move(task));
+    else pool.submitUrgent(std::move(task));
+}
+
+// Set by SIGINT/SIGTERM so the event loop can shut down cleanly
+static volatile std::sig_atomic_t serverStopSignal = 0;
+
+static void handleServerSignal(int) {
+    serverStopSignal = 1;
+}
+
+// Bind a listening Unix socket, replacing a stale socket file.
+// Returns -1 and prints the reason on failure.
+static int listenUnixSocket(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cout << "Error: Socket path is too long\n";
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cout << "Error: socket: " << std::strerror(errno) << "\n";
+        return -1;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+        std::cout << "Error: bind/listen: " << std::strerror(errno) << "\n";
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Event loop. Serves from the holder's current snapshot until stop is set
+// or a termination signal arrives. Returns a process exit status.
+static int runServer(const std::string& socketPath, const CatalogHolder& catalog,
+    const std::atomic<bool>& stop) {
+    const size_t kMaxRequestLine = 64 * 1024;
+    const size_t kMaxSendParts = 512;  // iovecs per sendmsg, below IOV_MAX
+
+    const int listenFd = listenUnixSocket(socketPath);
+    if (listenFd < 0) return 1;
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    // Workers report finished requests by connection fd and wake the loop
+    // through an eventfd.
+    const int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+    std::mutex completedMutex;
+    std::vector<int> completed;
+
+    struct Connection {
+        std::string in;
+        size_t sent = 0;  // bytes of responses.front() already sent
+        bool readClosed = false;
+        uint32_t watched = EPOLLIN;  // events registered with epoll
+        std::deque<std::shared_ptr<PendingResponse>> responses;
+    };
+    std::unordered_map<int, Connection> connections;
+    std::vector<char> chunk(64 * 1024);
+
+    // Joined before the descriptors its tasks signal are closed
+    auto pool = std::make_unique<WorkStealingPool>(std::max(1u, std::thread::hardware_concurrency()));
+
+    auto closeConnection = [&](int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    };
+
+    // Write as much finished output as the socket takes, stopping at the
+    // first request that is still running so responses stay in order.
+    // Short responses are staged into one buffer; a LIST body goes out
+    // straight from the catalog as its own piece of the same sendmsg.
+    // Readability is watched until the request stream ends, since
+    // level-triggered EPOLLIN stays set on a socket read to EOF;
+    // writability only while finished output is left over.
+    std::string staged;
+    std::vector<iovec> parts;  // a null base marks the next run of staged
+    auto flush = [&](int fd, Connection& conn) {
+        bool pending = false;
+        while (!pending) {
+            staged.clear();
+            parts.clear();
+            size_t skip = conn.sent;
+            size_t run = 0;  // staged bytes not yet covered by a part
+            for (const auto& r : conn.responses) {
+                if (!r->done.load(std::memory_order_acquire) || parts.size() + 2 > kMaxSendParts) break;
+                if (skip < r->out.size()) {
+                    staged.append(r->out, skip, std::string::npos);
+                    run += r->out.size() - skip;
+                    skip = 0;
+                }
+                else {
+                    skip -= r->out.size();
+                }
+                if (!r->shared) continue;
+                if (skip < r->shared->size()) {
+                    if (run > 0) parts.push_back({ nullptr, run });
+                    run = 0;
+                    parts.push_back({ const_cast<char*>(r->shared->data()) + skip, r->shared->size() - skip });
+                    skip = 0;
+                }
+                else {
+                    skip -= r->shared->size();
+                }
+            }
+            if (run > 0) parts.push_back({ nullptr, run });
+
+            // Point the staged runs into the buffer now that it has stopped growing
+            size_t total = 0;
+            size_t offset = 0;
+            for (iovec& part : parts) {
+                if (!part.iov_base) {
+                    part.iov_base = &staged[offset];
+                    offset += part.iov_len;
+                }
+                total += part.iov_len;
+            }
+            if (parts.empty()) break;
+
+            msghdr msg{};
+            msg.msg_iov = parts.data();
+            msg.msg_iovlen = parts.size();
+            const ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    pending = true;
+                    break;
+                }
+                return false;
+            }
+
+            // Drop the responses that went out in full
+            conn.sent += static_cast<size_t>(n);
+            while (!conn.responses.empty() && conn.responses.front()->done.load(std::memory_order_acquire)
+                && conn.sent >= conn.responses.front()->size()) {
+                conn.sent -= conn.responses.front()->size();
+                conn.responses.pop_front();
+            }
+            pending = static_cast<size_t>(n) < total;  // the socket buffer is full
+        }
+
+        const uint32_t wanted = (conn.readClosed ? 0u : EPOLLIN) | (pending ? EPOLLOUT : 0u);
+        if (wanted != conn.watched) {
+            epoll_event mod{};
+            mod.events = wanted;
+            mod.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &mod);
+            conn.watched = wanted;
+        }
+        return pending || !conn.readClosed || !conn.responses.empty();
+    };
+
+    std::vector<epoll_event> events(64);
+    while (!stop.load(std::memory_order_relaxed) && !serverStopSignal) {
+        const int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 200);
+        if (ready < 0 && errno != EINTR) {
+            std::cout << "Error: epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        for (int e = 0; e < ready; ++e) {
+            const int fd = events[e].data.fd;
+
+            if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {
+                }
+                std::vector<int> finished;
+                {
+                    std::lock_guard<std::mutex> lock(completedMutex);
+                    finished.swap(completed);
+                }
+                std::sort(finished.begin(), finished.end());
+                finished.erase(std::unique(finished.begin(), finished.end()), finished.end());
+                for (int cfd : finished) {
+                    auto it = connections.find(cfd);
+                    if (it == connections.end()) continue;
+                    if (!flush(cfd, it->second)) {
+                        closeConnection(cfd);
+                    }
+                }
+                continue;
+            }
+
+            if (fd == listenFd) {
+                while (true) {
+                    const int client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) break;
+                    epoll_event cev{};
+                    cev.events = EPOLLIN;
+                    cev.data.fd = client;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &cev);
+                    connections[client];
+                }
+                continue;
+            }
+
+            auto found = connections.find(fd);
+            if (found == connections.end()) continue;
+            Connection& conn = found->second;
+
+            // epoll reports these whatever the mask, and they stay set; the
+            // peer is gone, so no response could be delivered anyway
+            if (events[e].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(fd);
+                continue;
+            }
+
+            if (events[e].events & EPOLLIN) {
+                while (!conn.readClosed) {
+                    const ssize_t n = read(fd, chunk.data(), chunk.size());
+                    if (n > 0) {
+                        conn.in.append(chunk.data(), static_cast<size_t>(n));
+                    }
+                    else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                        conn.readClosed = true;
+                    }
+                    else {
+                        break;
+                    }
+                }
+
+                // Hand every complete line to the pool
+                size_t start = 0;
+                size_t nl = conn.in.find('\n');
+                while (nl != std::string::npos) {
+                    const std::string request = trim(conn.in.substr(start, nl - start));
+                    if (!request.empty()) {
+                        auto slot = std::make_shared<PendingResponse>();
+                        conn.responses.push_back(slot);
+                        dispatchQuery(*pool, catalog, request, slot, [&completedMutex, &completed, wakeFd, fd]() {
+                            {
+                                std::lock_guard<std::mutex> lock(completedMutex);
+                                completed.push_back(fd);
+                            }
+                            const uint64_t one = 1;
+                            (void)!write(wakeFd, &one, sizeof(one));
+                        });
+                    }
+                    start = nl + 1;
+                    nl = conn.in.find('\n', start);
+                }
+                conn.in.erase(0, start);
+                if (conn.in.size() > kMaxRequestLine) {
+                    auto slot = std::make_shared<PendingResponse>();
+                    slot->out = "ERR Request too long\n";
+                    slot->done.store(true, std::memory_order_relaxed);
+                    conn.responses.push_back(slot);
+                    conn.readClosed = true;
+                }
+            }
+
+            if (!flush(fd, conn)) {
+                closeConnection(fd);
+            }
+        }
+    }
+
+    pool.reset();
+    for (const auto& kv : connections) {
+        close(kv.first);
+    }
+    close(wakeFd);
+    close(epollFd);
+    close(listenFd);
+    unlink(socketPath.c_str());
+    return 0;
+}
+
+static int connectUnixSocket(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Reads framed responses from fd into buffer until `expected` responses
+// are complete, calling onResponse(ok, body) for each one.
+template <typename OnResponse>
+static bool readResponses(int fd, std::string& buffer, size_t expected, OnResponse onResponse) {
+    std::vector<char> chunk(64 * 1024);
+    size_t pos = 0;
+    while (expected > 0) {
+        // Parse whatever is already buffered
+        const size_t nl = buffer.find('\n', pos);
+        if (nl != std::string::npos) {
+            const std::string header = buffer.substr(pos, nl - pos);
+            if (header.compare(0, 3, "OK ") == 0) {
+                const size_t length = static_cast<size_t>(std::stoul(header.substr(3)));
+                if (buffer.size() - (nl + 1) >= length) {
+                    onResponse(true, buffer.substr(nl + 1, length));
+                    pos = nl + 1 + length;
+                    --expected;
+                    continue;
+                }
+            }
+            else {
+                onResponse(false, header.size() > 4 ? header.substr(4) : header);
+                pos = nl + 1;
+                --expected;
+                continue;
+            }
+        }
+
+        buffer.erase(0, pos);
+        pos = 0;
+        const ssize_t n = read(fd, chunk.data(), chunk.size());
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        buffer.append(chunk.data(), static_cast<size_t>(n));
+    }
+    buffer.erase(0, pos);
+    return true;
+}
+
+// Run with: artifact1 --client <socketPath>
+// Sends request lines from stdin and prints each response body, which
+// makes the server easy to exercise from a shell.
+static int runClient(const std::string& socketPath) {
+    const int fd = connectUnixSocket(socketPath);
+    if (fd < 0) {
+        std::cout << "Error: Could not connect to " << socketPath << "\n";
+        return 1;
+    }
+
+    std::string requests;
+    size_t count = 0;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (trim(line).empty()) continue;
+        requests += line;
+        requests += '\n';
+        ++count;
+    }
+
+    std::string buffer;
+    const bool ok = sendAll(fd, requests) && readResponses(fd, buffer, count,
+        [](bool success, const std::string& body) {
+            if (success) std::cout << body;
+            else std::cout << "Error: " << body << "\n";
+        });
+    close(fd);
+    return ok ? 0 : 1;
+}
+
+#endif
+
+// Split a user-entered list such as "CS300, cs310 CS320" into course numbers
+static std::vector<std::string> parseCourseList(const std::string& input) {
+    std::vector<std::string> out;
+    std::string token;
+    for (char ch : input + ",") {
+        if (ch == ',' || std::isspace(static_cast<unsigned char>(ch))) {
+            if (!token.empty()) {
+                out.push_back(toUpper(token));
+                token.clear();
+            }
+        }
+        else {
+            token += ch;
+        }
+    }
+    return out;
+}
+
+// -----------------------------
+// Batch query mode
+// -----------------------------
+// Run with: artifact1 --batch <csvFile> [commandFile]
+// Reads one command per line from commandFile (or stdin when omitted or "-")
+// and runs them back-to-back against a single loaded catalog:
+//   get <course>          course number, title and prerequisites
+//   list                  every course, sorted by number
+//   prereqs-all <course>  every direct and indirect prerequisite
+//   search <words>        courses whose titles contain every word, sorted
+//   complete <prefix>     course numbers and title words starting with prefix
+// No prompts are printed. Results go through one OutputBuffer, and the
+// query rate goes to stderr at the end.
+
+// Same text as printCourseDetails and printCourseSuggestions
+static void appendCourseDetails(const CatalogSnapshot& snap, const std::string& courseNumber,
+    OutputBuffer& out) {
+    const Course* found = snap.findCourse(courseNumber);
+    if (!found) {
+        out.append("Error: Course not found\n", 24);
+        std::vector<CourseSuggestion> suggestions;
+        suggestCourses(snap, courseNumber, suggestions);
+        if (!suggestions.empty()) out.append("Did you mean:\n", 14);
+        for (const CourseSuggestion& s : suggestions) {
+            const Course& c = *snap.loaded->ordered[s.position];
+            out.append("  ", 2);
+            out.appendCourseLine(c.courseNumber, c.title);
+        }
+        return;
+    }
+    const Course& c = *found;
+    out.appendCourseLine(c.courseNumber, c.title);
+    out.append("Prerequisites: ", 15);
+    if (c.prerequisites.empty()) out.append("None", 4);
+    for (size_t i = 0; i < c.prerequisites.size(); ++i) {
+        if (i) out.append(", ", 2);
+        out.append(c.prerequisites[i]);
+    }
+    out.append('\n');
+}
+
+// Same text as the first line of printPrerequisiteClosure
+static void appendAllPrerequisites(const CatalogSnapshot& snap, const std::string& courseNumber,
+    VisitMarks& marks, std::vector<uint32_t>& ids, OutputBuffer& out) {
+    const PrerequisiteGraph& g = snap.graph;
+    const int id = g.idOf(courseNumber);
+    if (id < 0 || !g.inCatalog(static_cast<uint32_t>(id))) {
+        out.append("Error: Course not found\n", 24);
+        return;
+    }
+
+    ids.clear();
+    marks.reset(g.size());
+    marks.mark(static_cast<uint32_t>(id));
+    collectClosure(g, { static_cast<uint32_t>(id) }, false, marks, ids);
+    std::sort(ids.begin(), ids.end());
+
+    out.append("All prerequisites: ", 19);
+    if (ids.empty()) out.append("None", 4);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i) out.append(", ", 2);
+        out.append(g.name(ids[i]));
+    }
+    out.append('\n');
+}
+
+static void appendTitleSearch(const CatalogSnapshot& snap, const std::string& query,
+    std::vector<uint32_t>& matches, OutputBuffer& out) {
+    searchTitleIndex(snap.loaded->titles, query, matches);
+    if (matches.empty()) out.append("No matching courses\n", 20);
+    for (uint32_t pos : matches) {
+        out.appendCourseLine(snap.loaded->ordered[pos]->courseNumber, snap.loaded->ordered[pos]->title);
+    }
+}
+
+static int runBatch(const std::string& csvFile, const std::string& commandFile) {
+    using Clock = std::chrono::steady_clock;
+
+    std::unordered_map<std::string, Course> loaded;
+    if (!loadCoursesFromCsv(csvFile, loaded)) {
+        std::cout << "Error: File not found or could not be opened\n";
+        return 1;
+    }
+    const auto snap = buildCatalogSnapshot(std::move(loaded));
+
+    std::string input;
+    if (commandFile.empty() || commandFile == "-") {
+        input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+    else {
+        std::ifstream in(commandFile, std::ios::binary);
+        if (!in.is_open()) {
+            std::cout << "Error: File not found or could not be opened\n";
+            return 1;
+        }
+        input.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    OutputBuffer out;
+    VisitMarks marks;
+    std::vector<uint32_t> ids;
+    std::string completions;
+    size_t queries = 0;
+
+    const auto start = Clock::now();
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t nl = input.find('\n', pos);
+        if (nl == std::string::npos) nl = input.size();
+        const std::string line = trim(input.substr(pos, nl - pos));
+        pos = nl + 1;
+        if (line.empty()) continue;
+
+        const size_t space = line.find(' ');
+        const std::string command = toUpper(line.substr(0, space));
+        const std::string arg = space == std::string::npos ? std::string()
+            : toUpper(trim(line.substr(space + 1)));
+
+        if (command == "GET" && !arg.empty()) {
+            appendCourseDetails(*snap, arg, out);
+        }
+        else if (command == "LIST") {
+            out.append(snap->loaded->sortedListing());
+        }
+        else if (command == "PREREQS-ALL" && !arg.empty()) {
+            appendAllPrerequisites(*snap, arg, marks, ids, out);
+        }
+        else if (command == "SEARCH" && !arg.empty()) {
+            appendTitleSearch(*snap, arg, ids, out);
+        }
+        else if (command == "COMPLETE" && !arg.empty()) {
+            completions.clear();
+            appendCompletions(*snap, arg, completions);
+            if (completions.empty()) out.append("No completions\n", 15);
+            out.append(completions);
+        }
+        else {
+            out.append("Error: Unknown command: ", 24);
+            out.append(line);
+            out.append('\n');
+        }
+        ++queries;
+    }
+    out.flush();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::cerr << "Ran " << queries << " queries in " << elapsed.count() << " s ("
+              << (elapsed.count() > 0 ? queries / elapsed.count() : 0.0) << " queries/s)\n";
+    return 0;
+}
+
+// -----------------------------
+// SQL over the loaded catalog
+// -----------------------------
+// Run with: artifact1 --sql <csvFile> [queryFile]
+// Requires building with -DWITH_SQLITE and linking SQLite. Two eponymous
+// virtual tables read straight from one catalog snapshot, nothing is
+// copied into SQLite:
+//   catalog_courses(course_number, title, prereq_count)
+//   catalog_prerequisites(course_number, prereq_number, position)
+// xBestIndex hands course_number constraints to the cursor: = becomes one
+// hash map lookup, and <, <=, >, >= become binary searches over the
+// snapshot's sorted course order. Rows come out in course number order, so
+// ORDER BY course_number needs no sort. Statements are read from queryFile
+// (or stdin) and rows are printed '|' separated.
+#if defined(WITH_SQLITE)
+
+// Constraint bits in idxNum; arguments arrive in this order in xFilter
+enum CatalogTableConstraint {
+    kCatalogEq = 1,
+    kCatalogGt = 2,
+    kCatalogGe = 4,
+    kCatalogLt = 8,
+    kCatalogLe = 16,
+};
+
+struct CatalogTableSpec {
+    const CatalogSnapshot* snap;
+    bool prerequisites;  // catalog_prerequisites rather than catalog_courses
+};
+
+struct CatalogVtab : sqlite3_vtab {
+    CatalogTableSpec spec;
+};
+
+struct CatalogCursor : sqlite3_vtab_cursor {
+    const CatalogSnapshot* snap = nullptr;
+    bool prerequisites = false;
+    const Course* const* pos = nullptr;   // current course
+    const Course* const* end = nullptr;
+    const Course* single = nullptr;        // target of an = lookup
+    size_t prereq = 0;                     // position within the course
+    sqlite3_int64 rowid = 0;
+
+    // Skips courses without prerequisites when walking edges
+    void settle() {
+        if (!prerequisites) return;
+        while (pos != end && prereq >= snap->current(**pos).prerequisites.size()) {
+            ++pos;
+            prereq = 0;
+        }
+    }
+};
+
+static int catalogConnect(sqlite3* db, void* aux, int, const char* const*, sqlite3_vtab** out, char**) {
+    const CatalogTableSpec* spec = static_cast<const CatalogTableSpec*>(aux);
+    const int rc = sqlite3_declare_vtab(db, spec->prerequisites
+        ? "CREATE TABLE x(course_number TEXT, prereq_number TEXT, position INTEGER)"
+        : "CREATE TABLE x(course_number TEXT, title TEXT, prereq_count INTEGER)");
+    if (rc != SQLITE_OK) return rc;
+
+    CatalogVtab* table = new (std::nothrow) CatalogVtab();
+    if (!table) return SQLITE_NOMEM;
+    table->spec = *spec;
+    *out = table;
+    return SQLITE_OK;
+}
+
+static int catalogDisconnect(sqlite3_vtab* table) {
+    delete static_cast<CatalogVtab*>(table);
+    return SQLITE_OK;
+}
+
+static int catalogBestIndex(sqlite3_vtab* base, sqlite3_index_info* info) {
+    const CatalogVtab* table = static_cast<const CatalogVtab*>(base);
+    const double rows = static_cast<double>(std::max<size_t>(table->spec.snap->loaded->ordered.size(), 1));
+
+    int eq = -1, lower = -1, upper = -1;
+    int lowerBit = 0, upperBit = 0;
+    for (int i = 0; i < info->nConstraint; ++i) {
+        const auto& c = info->aConstraint[i];
+        if (!c.usable || c.iColumn != 0) continue;
+        switch (c.op) {
+        case SQLITE_INDEX_CONSTRAINT_EQ:
+            eq = i;
+            break;
+        case SQLITE_INDEX_CONSTRAINT_GT:
+        case SQLITE_INDEX_CONSTRAINT_GE:
+            lower = i;
+            lowerBit = c.op == SQLITE_INDEX_CONSTRAINT_GT ? kCatalogGt : kCatalogGe;
+            break;
+        case SQLITE_INDEX_CONSTRAINT_LT:
+        case SQLITE_INDEX_CONSTRAINT_LE:
+            upper = i;
+            upperBit = c.op == SQLITE_INDEX_CONSTRAINT_LT ? kCatalogLt : kCatalogLe;
+            break;
+        default:
+            break;
+        }
+    }
+
+    int argc = 0;
+    auto use = [&](int constraint) {
+        info->aConstraintUsage[constraint].argvIndex = ++argc;
+        info->aConstraintUsage[constraint].omit = 1;
+    };
+    if (eq >= 0) {
+        use(eq);
+        info->idxNum = kCatalogEq;
+        info->estimatedCost = 1;
+        info->estimatedRows = table->spec.prerequisites ? 4 : 1;
+        if (!table->spec.prerequisites) info->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+    }
+    else {
+        info->idxNum = 0;
+        double fraction = 1;
+        if (lower >= 0) {
+            use(lower);
+            info->idxNum |= lowerBit;
+            fraction /= 4;
+        }
+        if (upper >= 0) {
+            use(upper);
+            info->idxNum |= upperBit;
+            fraction /= 4;
+        }
+        info->estimatedCost = std::log2(rows) + rows * fraction;
+        info->estimatedRows = static_cast<sqlite3_int64>(rows * fraction) + 1;
+    }
+
+    // Every path yields rows in ascending course number order
+    if (info->nOrderBy == 1 && info->aOrderBy[0].iColumn == 0 && !info->aOrderBy[0].desc) {
+        info->orderByConsumed = 1;
+    }
+    return SQLITE_OK;
+}
+
+static int catalogOpen(sqlite3_vtab* base, sqlite3_vtab_cursor** out) {
+    CatalogCursor* cursor = new (std::nothrow) CatalogCursor();
+    if (!cursor) return SQLITE_NOMEM;
+    cursor->snap = static_cast<const CatalogVtab*>(base)->spec.snap;
+    cursor->prerequisites = static_cast<const CatalogVtab*>(base)->spec.prerequisites;
+    *out = cursor;
+    return SQLITE_OK;
+}
+
+static int catalogClose(sqlite3_vtab_cursor* cursor) {
+    delete static_cast<CatalogCursor*>(cursor);
+    return SQLITE_OK;
+}
+
+static int catalogFilter(sqlite3_vtab_cursor* base, int idxNum, const char*, int argc, sqlite3_value** argv) {
+    CatalogCursor* cursor = static_cast<CatalogCursor*>(base);
+    const std::vector<const Course*>& ordered = cursor->snap->loaded->ordered;
+    cursor->pos = ordered.data();
+    cursor->end = ordered.data() + ordered.size();
+    cursor->prereq = 0;
+    cursor->rowid = 0;
+
+    // A NULL bound matches nothing
+    for (int i = 0; i < argc; ++i) {
+        if (sqlite3_value_type(argv[i]) == SQLITE_NULL) {
+            cursor->pos = cursor->end;
+            return SQLITE_OK;
+        }
+    }
+    auto key = [argv](int i) {
+        return std::string(reinterpret_cast<const char*>(sqlite3_value_text(argv[i])),
+            static_cast<size_t>(sqlite3_value_bytes(argv[i])));
+    };
+    auto before = [](const Course* c, const std::string& k) { return c->courseNumber < k; };
+    auto after = [](const std::string& k, const Course* c) { return k < c->courseNumber; };
+
+    int arg = 0;
+    if (idxNum & kCatalogEq) {
+        cursor->single = cursor->snap->findCourse(key(arg));
+        cursor->pos = &cursor->single;
+        cursor->end = cursor->single ? cursor->pos + 1 : cursor->pos;
+    }
+    else {
+        if (idxNum & (kCatalogGt | kCatalogGe)) {
+            const std::string k = key(arg++);
+            cursor->pos = idxNum & kCatalogGt ? std::upper_bound(cursor->pos, cursor->end, k, after)
+                                              : std::lower_bound(cursor->pos, cursor->end, k, before);
+        }
+        if (idxNum & (kCatalogLt | kCatalogLe)) {
+            const std::string k = key(arg++);
+            cursor->end = idxNum & kCatalogLt ? std::lower_bound(cursor->pos, cursor->end, k, before)
+                                              : std::upper_bound(cursor->pos, cursor->end, k, after);
+        }
+    }
+    cursor->settle();
+    return SQLITE_OK;
+}
+
+static int catalogNext(sqlite3_vtab_cursor* base) {
+    CatalogCursor* cursor = static_cast<CatalogCursor*>(base);
+    ++cursor->rowid;
+    if (cursor->prerequisites) {
+        ++cursor->prereq;
+    }
+    else {
+        ++cursor->pos;
+    }
+    cursor->settle();
+    return SQLITE_OK;
+}
+
+static int catalogEof(sqlite3_vtab_cursor* base) {
+    const CatalogCursor* cursor = static_cast<const CatalogCursor*>(base);
+    return cursor->pos == cursor->end ? 1 : 0;
+}
+
+static int catalogColumn(sqlite3_vtab_cursor* base, sqlite3_context* ctx, int col) {
+    const CatalogCursor* cursor = static_cast<const CatalogCursor*>(base);
+    const Course& c = cursor->snap->current(**cursor->pos);
+    // The snapshot outlives the statement, so SQLite can use the bytes in place
+    auto text = [ctx](const std::string& value) {
+        sqlite3_result_text(ctx, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+    };
+    if (col == 0) {
+        text(c.courseNumber);
+    }
+    else if (cursor->prerequisites) {
+        if (col == 1) text(c.prerequisites[cursor->prereq]);
+        else sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(cursor->prereq));
+    }
+    else {
+        if (col == 1) text(c.title);
+        else sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(c.prerequisites.size()));
+    }
+    return SQLITE_OK;
+}
+
+static int catalogRowid(sqlite3_vtab_cursor* base, sqlite3_int64* out) {
+    *out = static_cast<const CatalogCursor*>(base)->rowid;
+    return SQLITE_OK;
+}
+
+// Eponymous-only (no xCreate): the tables exist on every connection the
+// module is registered on
+static sqlite3_module makeCatalogModule() {
+    sqlite3_module module;
+    std::memset(&module, 0, sizeof(module));
+    module.iVersion = 1;
+    module.xConnect = catalogConnect;
+    module.xBestIndex = catalogBestIndex;
+    module.xDisconnect = catalogDisconnect;
+    module.xOpen = catalogOpen;
+    module.xClose = catalogClose;
+    module.xFilter = catalogFilter;
+    module.xNext = catalogNext;
+    module.xEof = catalogEof;
+    module.xColumn = catalogColumn;
+    module.xRowid = catalogRowid;
+    return module;
+}
+
+static const sqlite3_module kCatalogModule = makeCatalogModule();
+
+// Opens an in-memory connection exposing snap. The specs must outlive it.
+static sqlite3* openCatalogSql(CatalogTableSpec (&specs)[2]) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK
+        || sqlite3_create_module(db, "catalog_courses", &kCatalogModule, &specs[0]) != SQLITE_OK
+        || sqlite3_create_module(db, "catalog_prerequisites", &kCatalogModule, &specs[1]) != SQLITE_OK) {
+        std::cout << "Error: " << sqlite3_errmsg(db) << "\n";
+        sqlite3_close(db);
+        return nullptr;
+    }
+    return db;
+}
+
+// Runs every statement in sql, printing result rows '|' separated
+static size_t runSqlStatements(sqlite3* db, const std::string& sql, OutputBuffer& out) {
+    size_t statements = 0;
+    const char* tail = sql.c_str();
+    while (*tail) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, tail, -1, &stmt, &tail) != SQLITE_OK) {
+            out.append("Error: ", 7);
+            out.append(std::string(sqlite3_errmsg(db)));
+            out.append('\n');
+            break;
+        }
+        if (!stmt) continue;  // whitespace or comment
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            const int columns = sqlite3_column_count(stmt);
+            for (int i = 0; i < columns; ++i) {
+                if (i) out.append('|');
+                const unsigned char* value = sqlite3_column_text(stmt, i);
+                if (value) out.append(reinterpret_cast<const char*>(value), static_cast<size_t>(sqlite3_column_bytes(stmt, i)));
+            }
+            out.append('\n');
+        }
+        if (rc != SQLITE_DONE) {
+            out.append("Error: ", 7);
+            out.append(std::string(sqlite3_errmsg(db)));
+            out.append('\n');
+        }
+        sqlite3_finalize(stmt);
+        ++statements;
+    }
+    return statements;
+}
+
+static int runSql(const std::string& csvFile, const std::string& queryFile) {
+    std::unordered_map<std::string, Course> loaded;
+    if (!loadCoursesFromCsv(csvFile, loaded)) {
+        std::cout << "Error: File not found or could not be opened\n";
+        return 1;
+    }
+    const auto snap = buildCatalogSnapshot(std::move(loaded));
+
+    std::string sql;
+    if (queryFile.empty() || queryFile == "-") {
+        sql.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+    else {
+        std::ifstream in(queryFile, std::ios::binary);
+        if (!in.is_open()) {
+            std::cout << "Error: File not found or could not be opened\n";
+            return 1;
+        }
+        sql.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    CatalogTableSpec specs[2] = { { snap.get(), false }, { snap.get(), true } };
+    sqlite3* db = openCatalogSql(specs);
+    if (!db) return 1;
+
+    OutputBuffer out;
+    runSqlStatements(db, sql, out);
+    out.flush();
+    sqlite3_close(db);
+    return 0;
+}
+
+#endif
+
+// -----------------------------
+// Benchmarks
+// -----------------------------
+// Run with: artifact1 --bench <name> [courseCount]
+// Benchmarks use a generated catalog so results do not depend on the
+// size of the sample CSV.
+
+static const char* const kSyntheticTitleWords[64] = {
+    "Advanced", "Algorithms", "Analysis", "Applied", "Architecture", "Artificial", "Biology", "Calculus",
+    "Chemistry", "Cloud", "Communication", "Compilers", "Computer", "Computing", "Data", "Databases",
+    "Design", "Digital", "Discrete", "Distributed", "Economics", "Embedded", "Engineering", "Ethics",
+    "Finance", "Foundations", "Games", "Geometry", "Graphics", "History", "Human", "Information",
+    "Intelligence", "Interaction", "Introduction", "Language", "Learning", "Linear", "Logic", "Machine",
+    "Management", "Mathematics", "Methods", "Mobile", "Modeling", "Networks", "Operating", "Optimization",
+    "Parallel", "Physics", "Principles", "Probability", "Programming", "Quantum", "Research", "Robotics",
+    "Security", "Seminar", "Software", "Statistics", "Structures", "Systems", "Theory", "Visualization",
+};
+
+// Two or three words from the vocabulary (each in about 4% of titles),
+// plus "Capstone" on every thousandth course
+static std::string syntheticCourseTitle(size_t i) {
+    uint64_t h = (i + 1) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    std::string title = kSyntheticTitleWords[h & 63];
+    title += ' ';
+    title += kSyntheticTitleWords[(h >> 6) & 63];
+    if ((h >> 12) & 1) {
+        title += ' ';
+        title += kSyntheticTitleWords[(h >> 13) & 63];
+    }
+    if (i % 1000 == 999) title += " Capstone";
+    return title;
+}
+
+// Generate a layered, acyclic catalog: course i takes up to three
+// prerequisites chosen from the 200 courses before it.
+static std::unordered_map<std::string, Course> makeSyntheticCatalog(size_t count) {
+    std::unordered_map<std::string, Course> courses;
+    courses.reserve(count);
+
+    auto numberFor = [](size_t i) {
+        std::string digits = std::to_string(i);
+        return "C" + std::string(digits.size() < 7 ? 7 - digits.size() : 0, '0') + digits;
+    };
+
+    uint64_t state = 88172645463325252ULL;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        Course c;
+        c.courseNumber = numberFor(i);
+        c.title = syntheticCourseTitle(i);
+        const size_t prereqs = i == 0 ? 0 : next() % 4;
+        for (size_t k = 0; k < prereqs; ++k) {
+            const size_t window = std::min<size_t>(i, 200);
+            c.prerequisites.push_back(numberFor(i - 1 - next() % window));
+        }
+        courses.emplace(c.courseNumber, std::move(c));
+    }
+    return courses;
+}
+
+// Prerequisite closure by name: resolve every edge through the hash map,
+// as traversals over the plain course map had to before the CSR existed.
+static size_t closureByName(
+    const std::unordered_map<std::string, Course>& courses,
+    const std::string& start
+) {
+    std::unordered_map<std::string, bool> seen;
+    std::vector<const Course*> queue{ &courses.at(start) };
+    seen[start] = true;
+
+    for (size_t i = 0; i < queue.size(); ++i) {
+        for (const auto& p : queue[i]->prerequisites) {
+            if (seen.emplace(p, true).second) {
+                const auto it = courses.find(p);
+                if (it != courses.end()) queue.push_back(&it->second);
+            }
+        }
+    }
+    return seen.size() - 1;
+}
+
+static void benchGraphTraversal(size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto courses = makeSyntheticCatalog(count);
+    auto start = Clock::now();
+    const PrerequisiteGraph g = buildPrerequisiteGraph(courses);
+    const std::chrono::duration<double> build = Clock::now() - start;
+
+    // Start from courses spread over the top half of the catalog, where
+    // closures are large enough to dominate the measurement.
+    std::vector<uint32_t> starts;
+    for (size_t i = 0; i < 32; ++i) {
+        starts.push_back(static_cast<uint32_t>(g.size() / 2 + (g.size() / 2) * i / 32));
+    }
+
+    size_t visitedByName = 0;
+    start = Clock::now();
+    for (uint32_t s : starts) {
+        visitedByName += closureByName(courses, g.name(s));
+    }
+    const std::chrono::duration<double> byName = Clock::now() - start;
+
+    size_t visitedCsr = 0;
+    VisitMarks marks;
+    std::vector<uint32_t> out;
+    start = Clock::now();
+    for (uint32_t s : starts) {
+        out.clear();
+        marks.reset(g.size());
+        marks.mark(s);
+        collectClosure(g, { s }, false, marks, out);
+        visitedCsr += out.size();
+    }
+    const std::chrono::duration<double> csr = Clock::now() - start;
+
+    size_t edges = 0;
+    for (const auto& kv : courses) edges += kv.second.prerequisites.size();
+    std::cout << "Courses: " << count << ", edges: " << edges
+              << ", CSR build: " << build.count() * 1e3 << " ms\n";
+    std::cout << "Name-resolving BFS: " << byName.count() * 1e3 << " ms ("
+              << visitedByName << " visits)\n";
+    std::cout << "CSR BFS:            " << csr.count() * 1e3 << " ms ("
+              << visitedCsr << " visits)\n";
+    std::cout << "Speedup: " << byName.count() / csr.count() << "x\n";
+}
+
+// Random prerequisite additions applied through the dynamic order, compared
+// with the cost of recomputing a full topological order once. Then the
+// same kind of edits end to end, as the menu applies them: the dynamic
+// order, the copy-on-write CSR and planner patch, and publishing the
+// patched snapshot, against one snapshot rebuild.
+static void benchIncrementalTopo(size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto courses = makeSyntheticCatalog(count);
+    const PrerequisiteGraph g = buildPrerequisiteGraph(courses);
+
+    auto start = Clock::now();
+    std::vector<uint32_t> order;
+    topologicalOrder(g, order);
+    const std::chrono::duration<double> full = Clock::now() - start;
+
+    DynamicTopoOrder topo;
+    topo.reset(g);
+
+    // Local edits like a committee adjusting related courses: most add an
+    // earlier course as a prerequisite, one in ten points the other way.
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    const size_t edits = 10000;
+    size_t accepted = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < edits; ++i) {
+        const size_t c = 1 + next() % (g.size() - 1);
+        size_t p = c - 1 - next() % std::min<size_t>(c, 200);
+        if (next() % 10 == 0) p = std::min(g.size() - 1, c + 1 + next() % 200);
+        if (topo.addEdge(g.name(c), g.name(p))) ++accepted;
+    }
+    const std::chrono::duration<double> incremental = Clock::now() - start;
+
+    std::cout << "Courses: " << count << ", full topological sort: " << full.count() * 1e3 << " ms\n";
+    std::cout << "Incremental edits: " << edits << " (" << accepted << " accepted, "
+              << edits - accepted << " rejected as cycles), "
+              << incremental.count() * 1e6 / edits << " us/edit\n";
+    std::cout << "Order valid: " << (topo.verify() ? "yes" : "NO") << "\n";
+
+    start = Clock::now();
+    CatalogHolder holder;
+    holder.publish(buildCatalogSnapshot(courses));
+    const std::chrono::duration<double> rebuild = Clock::now() - start;
+    topo.reset(holder.read()->graph);
+
+    VisitMarks marks;
+    size_t patched = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < edits; ++i) {
+        const size_t c = 1 + next() % (g.size() - 1);
+        size_t p = c - 1 - next() % std::min<size_t>(c, 200);
+        if (next() % 10 == 0) p = std::min(g.size() - 1, c + 1 + next() % 200);
+        if (!topo.addEdge(g.name(c), g.name(p))) continue;
+        auto next = patchPrerequisiteEdge(*holder.read(), topo, marks, g.name(c), g.name(p), true);
+        if (!next) continue;
+        holder.publish(std::move(next));
+        ++patched;
+    }
+    const std::chrono::duration<double> applied = Clock::now() - start;
+
+    std::cout << "Snapshot rebuild: " << rebuild.count() * 1e3 << " ms; edits with CSR and planner patch: "
+              << patched << " applied, " << applied.count() * 1e6 / edits << " us/edit\n";
+}
+
+// Reader threads look courses up continuously while the main thread keeps
+// publishing freshly built catalogs. Every lookup cross-checks the pinned
+// snapshot's course map against its own CSR, so a reader that saw a torn or
+// freed snapshot shows up as a failure (or a crash under ASan).
+static void benchSnapshotReload(size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    CatalogHolder holder;
+    holder.publish(buildCatalogSnapshot(makeSyntheticCatalog(count)));
+
+    std::atomic<bool> stop{ false };
+    std::atomic<size_t> lookups{ 0 };
+    std::atomic<size_t> failures{ 0 };
+
+    auto reader = [&](size_t seed) {
+        size_t local = 0;
+        size_t bad = 0;
+        size_t i = seed * 7919;
+        while (!stop.load(std::memory_order_relaxed)) {
+            const auto snap = holder.read();
+            const PrerequisiteGraph& g = snap->graph;
+            for (size_t k = 0; k < 64; ++k, ++i) {
+                const uint32_t id = static_cast<uint32_t>(i % g.size());
+                const Course* c = snap->findCourse(g.name(id));
+                if ((c != nullptr) != g.inCatalog(id) ||
+                    (c && c->prerequisites.size() != g.prerequisites[id].size())) {
+                    ++bad;
+                }
+                ++local;
+            }
+        }
+        lookups += local;
+        failures += bad;
+    };
+
+    const size_t readerCount = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < readerCount; ++t) {
+        readers.emplace_back(reader, t);
+    }
+
+    // Alternate between two catalog sizes so consecutive snapshots differ
+    const size_t reloads = 20;
+    const auto start = Clock::now();
+    for (size_t r = 0; r < reloads; ++r) {
+        holder.publish(buildCatalogSnapshot(makeSyntheticCatalog(r % 2 ? count : count / 2 + 1)));
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    stop = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+    const size_t leftover = holder.reclaim();
+
+    std::cout << "Readers: " << readerCount << ", reloads: " << reloads
+              << " in " << elapsed.count() << " s\n";
+    std::cout << "Lookups during reloads: " << lookups.load() << " ("
+              << lookups.load() / elapsed.count() << "/s), failures: " << failures.load() << "\n";
+    std::cout << "Snapshots still retired after readers exit: " << leftover << "\n";
+}
+
+#if defined(__linux__)
+// Pipelined GET requests against a server thread on a scratch socket
+static void benchServer(size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    CatalogHolder holder;
+    holder.publish(buildCatalogSnapshot(makeSyntheticCatalog(count)));
+    // Held for as long as g is used
+    const auto snap = holder.read();
+    const PrerequisiteGraph& g = snap->graph;
+
+    const std::string path = "/tmp/artifact1-bench-" + std::to_string(getpid()) + ".sock";
+    std::atomic<bool> stop{ false };
+    std::thread server([&]() { runServer(path, holder, stop); });
+
+    int fd = -1;
+    for (int attempt = 0; attempt < 100 && fd < 0; ++attempt) {
+        fd = connectUnixSocket(path);
+        if (fd < 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (fd < 0) {
+        std::cout << "Error: Could not connect to benchmark server\n";
+        stop = true;
+        server.join();
+        return;
+    }
+
+    const size_t total = 200000;
+    const size_t batch = 1000;
+    size_t okCount = 0;
+    std::string requests;
+    std::string buffer;
+    const auto start = Clock::now();
+    for (size_t sent = 0; sent < total; sent += batch) {
+        requests.clear();
+        for (size_t i = 0; i < batch; ++i) {
+            requests += "GET ";
+            requests += g.name((sent + i) * 7919 % g.size());
+            requests += '\n';
+        }
+        if (!sendAll(fd, requests) ||
+            !readResponses(fd, buffer, batch, [&](bool ok, const std::string&) { okCount += ok; })) {
+            std::cout << "Error: Connection lost\n";
+            break;
+        }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    // Round-trip latency of single lookups while another client keeps the
+    // pool busy with full listings
+    std::atomic<bool> listing{ true };
+    size_t listings = 0;
+    std::thread bulk([&]() {
+        const int bulkFd = connectUnixSocket(path);
+        std::string bulkBuffer;
+        while (bulkFd >= 0 && listing.load()) {
+            if (!sendAll(bulkFd, "LIST\n") ||
+                !readResponses(bulkFd, bulkBuffer, 1, [](bool, const std::string&) {})) {
+                break;
+            }
+            ++listings;
+        }
+        if (bulkFd >= 0) close(bulkFd);
+    });
+
+    std::vector<double> latencies;
+    for (size_t i = 0; i < 2000; ++i) {
+        const auto sentAt = Clock::now();
+        if (!sendAll(fd, "GET " + g.name(i * 7919 % g.size()) + "\n") ||
+            !readResponses(fd, buffer, 1, [](bool, const std::string&) {})) {
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sentAt).count());
+    }
+    listing = false;
+    bulk.join();
+    std::sort(latencies.begin(), latencies.end());
+
+    close(fd);
+    stop = true;
+    server.join();
+
+    std::cout << "Courses: " << count << ", requests: " << total << " (" << okCount << " OK), "
+              << "pipeline depth: " << batch << "\n";
+    std::cout << "Throughput: " << total / elapsed.count() << " lookups/s (client and server on "
+              << std::thread::hardware_concurrency() << " core(s))\n";
+    if (!latencies.empty()) {
+        std::cout << "GET latency during " << listings << " concurrent LISTs: p50 "
+                  << latencies[latencies.size() / 2] << " us, p99 "
+                  << latencies[latencies.size() * 99 / 100] << " us\n";
+    }
+}
+#endif
+
+// Radix key sort against std::sort on shuffled course numbers shaped like
+// buildPrerequisiteGraph's input: mixed department codes and repeats
+static void benchSortKeys(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    static const char* const departments[] = { "CS", "MAT", "PHY", "ENG", "BIO", "CHEM", "HIST", "ECON" };
+
+    uint64_t state = 88172645463325252ULL;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    const size_t distinct = std::max<size_t>(1, count * 2 / 3);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t n = next() % distinct;
+        keys.push_back(std::string(departments[n % 8]) + std::to_string(100000 + n / 8));
+    }
+
+    std::vector<std::string> expected = keys;
+    auto start = Clock::now();
+    std::sort(expected.begin(), expected.end());
+    const std::chrono::duration<double> comparison = Clock::now() - start;
+
+    start = Clock::now();
+    sortCourseNumbers(keys);
+    const std::chrono::duration<double> radix = Clock::now() - start;
+
+    std::cout << "Keys: " << count << (count < kRadixSortThreshold ? " (below radix threshold)" : "") << "\n";
+    std::cout << "std::sort:         " << comparison.count() * 1e3 << " ms\n";
+    std::cout << "sortCourseNumbers: " << radix.count() * 1e3 << " ms ("
+              << (keys == expected ? "same order" : "ORDER MISMATCH") << ")\n";
+    std::cout << "Speedup: " << comparison.count() / radix.count() << "x\n";
+}
+
+// JSON and NDJSON export throughput to a scratch file in the working
+// directory, which is removed afterwards
+static void benchExport(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    const std::string path = "bench_export.json";
+
+    const auto snap = buildCatalogSnapshot(makeSyntheticCatalog(count));
+    std::cout << "Courses: " << count << "\n";
+
+    for (const bool ndjson : { false, true }) {
+        size_t exported = 0;
+        const auto start = Clock::now();
+        const bool ok = exportCatalogJson(*snap, path, ndjson, exported);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::ifstream written(path, std::ios::binary | std::ios::ate);
+        const double megabytes = static_cast<double>(written.tellg()) / (1024.0 * 1024.0);
+        std::cout << (ndjson ? "NDJSON: " : "JSON:   ") << (ok ? "" : "(write failed) ")
+                  << megabytes << " MB in " << elapsed.count() * 1e3 << " ms ("
+                  << megabytes / elapsed.count() << " MB/s)\n";
+    }
+    std::remove(path.c_str());
+}
+
+// Keyword queries through the title index versus tokenizing every title,
+// for a rare word, common words, and ANDs mixing the two
+static void benchTitleSearch(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    using Us = std::chrono::duration<double, std::micro>;
+
+    auto catalog = makeSyntheticCatalog(count);
+    auto start = Clock::now();
+    const auto snap = buildCatalogSnapshot(std::move(catalog));
+    const double snapshotMs = Us(Clock::now() - start).count() / 1000;
+    start = Clock::now();
+    const TitleIndex rebuilt = buildTitleIndex(snap->loaded->ordered);
+    const double buildMs = Us(Clock::now() - start).count() / 1000;
+
+    size_t postings = 0;
+    for (uint32_t n : rebuilt.docCount) postings += n;
+    std::cout << "Courses: " << count << ", terms: " << rebuilt.terms.size() << ", postings: " << postings << "\n";
+    std::cout << "Index build: " << buildMs << " ms of a " << snapshotMs << " ms snapshot build, " << rebuilt.postingBytes() / 1024 << " KB ("
+              << rebuilt.bytes.size() / 1024 << " KB of deltas vs " << postings * 4 / 1024
+              << " KB as plain uint32)\n";
+
+    // Baseline: every word of every title checked against the query words
+    auto scan = [&](const std::string& query, std::vector<uint32_t>& out) {
+        out.clear();
+        std::vector<std::string> words;
+        std::string term;
+        forEachTitleTerm(query, term, [&](const std::string& t) { words.push_back(t); });
+        std::vector<uint8_t> found(words.size());
+        for (uint32_t pos = 0; pos < snap->loaded->ordered.size(); ++pos) {
+            std::fill(found.begin(), found.end(), 0);
+            forEachTitleTerm(snap->loaded->ordered[pos]->title, term, [&](const std::string& t) {
+                for (size_t w = 0; w < words.size(); ++w) {
+                    if (words[w] == t) found[w] = 1;
+                }
+            });
+            if (std::find(found.begin(), found.end(), 0) == found.end()) out.push_back(pos);
+        }
+    };
+
+    const char* const queries[] = {
+        "capstone", "security", "data structures", "capstone security", "machine learning systems",
+    };
+    for (const char* query : queries) {
+        std::vector<uint32_t> matches, expected;
+        const int repeats = 200;
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r) searchTitleIndex(snap->loaded->titles, query, matches);
+        const double indexUs = Us(Clock::now() - start).count() / repeats;
+
+        start = Clock::now();
+        scan(query, expected);
+        const double scanUs = Us(Clock::now() - start).count();
+
+        std::cout << "\"" << query << "\": " << matches.size() << " matches, " << indexUs << " us indexed, "
+                  << scanUs / 1000 << " ms scanned (" << scanUs / indexUs << "x)"
+                  << (matches == expected ? "" : ", MISMATCH") << "\n";
+    }
+}
+
+// Suggestions for mistyped course numbers and titles, against checking the
+// query's distance to every course number
+static void benchFuzzyLookup(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    using Us = std::chrono::duration<double, std::micro>;
+
+    const auto snap = buildCatalogSnapshot(makeSyntheticCatalog(count));
+    auto start = Clock::now();
+    const auto& ordered = snap->loaded->ordered;
+    const TrigramIndex rebuilt = buildTrigramIndex(ordered.size(),
+        [&ordered](size_t i) -> const std::string& { return ordered[i]->courseNumber; });
+    const double buildMs = Us(Clock::now() - start).count() / 1000;
+    std::cout << "Courses: " << count << ", number trigram index: " << rebuilt.slots.size() << " trigrams, "
+              << rebuilt.keys.size() << " entries, built in " << buildMs << " ms\n";
+
+    // Typos of existing numbers: substitution, deletion, insertion, transposition
+    const std::string base = ordered[count / 2 + std::min<size_t>(count / 4, 1234)]->courseNumber;
+    std::string substituted = base, deleted = base, inserted = base, swapped = base;
+    substituted[4] = 'O';
+    deleted.erase(3, 1);
+    inserted.insert(5, "7");
+    std::swap(swapped[5], swapped[6]);
+    const std::string queries[] = {
+        substituted, deleted, inserted, swapped, "data structers", "machne lerning", "xyzzy",
+    };
+
+    for (const std::string& query : queries) {
+        std::vector<CourseSuggestion> suggestions;
+        const int repeats = 100;
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r) suggestCourses(*snap, query, suggestions);
+        const double fuzzyUs = Us(Clock::now() - start).count() / repeats;
+
+        // Baseline: bounded distance to every course number
+        const uint32_t limit = fuzzyDistanceLimit(query.size());
+        const MyersPattern pattern(query);
+        uint32_t best = limit + 1, bestPos = 0;
+        start = Clock::now();
+        for (uint32_t pos = 0; pos < ordered.size(); ++pos) {
+            const uint32_t d = boundedLevenshtein(pattern, ordered[pos]->courseNumber, limit);
+            if (d < best) {
+                best = d;
+                bestPos = pos;
+            }
+        }
+        const double scanUs = Us(Clock::now() - start).count();
+
+        std::cout << "\"" << query << "\": " << suggestions.size() << " suggestions";
+        if (!suggestions.empty()) {
+            std::cout << " (first " << ordered[suggestions[0].position]->courseNumber << ", distance "
+                      << suggestions[0].distance << ")";
+        }
+        std::cout << ", " << fuzzyUs << " us; scanning every number " << scanUs / 1000 << " ms";
+        if (best <= limit) std::cout << " (" << ordered[bestPos]->courseNumber << ", distance " << best << ")";
+        std::cout << "\n";
+    }
+}
+
+// Top-k completions for course-number prefixes on the synthetic catalog,
+// and for word prefixes on a generated vocabulary (the synthetic titles
+// only use a few dozen words), against scanning for the same answers
+static void benchCompletion(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    using Us = std::chrono::duration<double, std::micro>;
+    const int repeats = 10000;
+
+    const auto snap = buildCatalogSnapshot(makeSyntheticCatalog(count));
+    const std::string last = snap->loaded->ordered.back()->courseNumber;
+    std::cout << "Courses: " << count << "\n";
+    std::vector<const Course*> courses;
+    for (size_t len : { size_t{1}, size_t{3}, size_t{5}, last.size() }) {
+        const std::string prefix = last.substr(0, len);
+        auto start = Clock::now();
+        for (int r = 0; r < repeats; ++r) completeCourseNumbers(snap->loaded->ordered, prefix, kCompletionLimit, courses);
+        const double fastUs = Us(Clock::now() - start).count() / repeats;
+
+        // Baseline: walk the courses in order until k matches are found
+        size_t found = 0;
+        start = Clock::now();
+        for (const Course* c : snap->loaded->ordered) {
+            if (hasPrefix(c->courseNumber, prefix) && ++found == kCompletionLimit) break;
+        }
+        const double scanUs = Us(Clock::now() - start).count();
+        std::cout << "number \"" << prefix << "\": " << courses.size() << " completions, " << fastUs
+                  << " us (scan " << scanUs << " us)\n";
+    }
+
+    // Vocabulary: count distinct words over a 16-letter alphabet with
+    // skewed course counts
+    TitleIndex vocabulary;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    while (vocabulary.termText.size() < count) {
+        std::string word;
+        const size_t length = 3 + next() % 8;
+        for (size_t i = 0; i < length; ++i) word += static_cast<char>('a' + next() % 16);
+        if (!vocabulary.terms.emplace(word, static_cast<uint32_t>(vocabulary.termText.size())).second) continue;
+        vocabulary.termText.push_back(word);
+        vocabulary.docCount.push_back(static_cast<uint32_t>(1 + 100000 / (1 + next() % 10000)));
+    }
+    auto start = Clock::now();
+    const PrefixIndex words = buildPrefixIndex(vocabulary);
+    const double buildMs = Us(Clock::now() - start).count() / 1000;
+    size_t tableEntries = 0;
+    for (const auto& level : words.widest) tableEntries += level.size();
+    std::cout << "Vocabulary: " << count << " words, prefix index built in " << buildMs << " ms ("
+              << (words.terms.size() + tableEntries) * 4 / 1024 << " KB)\n";
+
+    std::vector<uint32_t> top;
+    for (const char* prefix : { "a", "ab", "abc", "abcd" }) {
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r) completeTitleWords(vocabulary, words, prefix, kCompletionLimit, top);
+        const double fastUs = Us(Clock::now() - start).count() / repeats;
+
+        // Baseline: collect every word with the prefix and keep the top k
+        start = Clock::now();
+        std::vector<uint32_t> matches;
+        for (uint32_t t = 0; t < vocabulary.termText.size(); ++t) {
+            if (hasPrefix(vocabulary.termText[t], prefix)) matches.push_back(t);
+        }
+        const size_t keep = std::min(matches.size(), kCompletionLimit);
+        std::partial_sort(matches.begin(), matches.begin() + keep, matches.end(), [&](uint32_t a, uint32_t b) {
+            return vocabulary.docCount[a] != vocabulary.docCount[b] ? vocabulary.docCount[a] > vocabulary.docCount[b]
+                : vocabulary.termText[a] < vocabulary.termText[b];
+        });
+        matches.resize(keep);
+        const double scanUs = Us(Clock::now() - start).count();
+        std::cout << "word \"" << prefix << "\": " << top.size() << " completions, " << fastUs << " us (scan "
+                  << scanUs << " us)" << (top == matches ? "" : ", MISMATCH") << "\n";
+    }
+}
+
+#if defined(WITH_SQLITE)
+// Point, range and prerequisite queries through the catalog virtual
+// tables, each with the course_number constraint pushed down and with it
+// hidden from xBestIndex by writing +course_number, which forces a scan
+static void benchSql(size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto snap = buildCatalogSnapshot(makeSyntheticCatalog(count));
+    CatalogTableSpec specs[2] = { { snap.get(), false }, { snap.get(), true } };
+    sqlite3* db = openCatalogSql(specs);
+    if (!db) return;
+
+    const size_t span = std::min<size_t>(100, count);
+    auto timeQuery = [&](const std::string& sql, size_t iterations) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cout << "Error: " << sqlite3_errmsg(db) << "\n";
+            return 0.0;
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            const size_t first = state % (count - span + 1);
+            const std::string& low = snap->loaded->ordered[first]->courseNumber;
+            const std::string& high = snap->loaded->ordered[first + span - 1]->courseNumber;
+            sqlite3_bind_text(stmt, 1, low.data(), static_cast<int>(low.size()), SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, high.data(), static_cast<int>(high.size()), SQLITE_STATIC);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+            }
+            sqlite3_reset(stmt);
+        }
+        const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        sqlite3_finalize(stmt);
+        return elapsed.count() / iterations;
+    };
+
+    struct Query {
+        const char* label;
+        const char* sql;  // %s marks the column reference
+    };
+    const Query queries[] = {
+        { "point lookup", "SELECT title FROM catalog_courses WHERE %s = ?1" },
+        { "range of 100", "SELECT course_number FROM catalog_courses WHERE %s BETWEEN ?1 AND ?2" },
+        { "prerequisites", "SELECT prereq_number FROM catalog_prerequisites WHERE %s = ?1" },
+    };
+
+    std::cout << "Courses: " << count << "\n";
+    for (const Query& q : queries) {
+        std::string pushed = q.sql, scanned = q.sql;
+        pushed.replace(pushed.find("%s"), 2, "course_number");
+        scanned.replace(scanned.find("%s"), 2, "+course_number");
+        const double fast = timeQuery(pushed, 100000);
+        const double slow = timeQuery(scanned, 20);
+        std::cout << q.label << ": " << fast << " us pushed down, " << slow << " us scanned ("
+                  << slow / fast << "x)\n";
+    }
+    sqlite3_close(db);
+}
+#endif
+
+static int runBenchmark(const std::string& name, size_t count) {
+    if (name == "graph") {
+        benchGraphTraversal(count);
+        return 0;
+    }
+    if (name == "topo") {
+        benchIncrementalTopo(count);
+        return 0;
+    }
+    if (name == "reload") {
+        benchSnapshotReload(count);
+        return 0;
+    }
+    if (name == "sort") {
+        benchSortKeys(count);
+        return 0;
+    }
+    if (name == "export") {
+        benchExport(count);
+        return 0;
+    }
+    if (name == "search") {
+        benchTitleSearch(count);
+        return 0;
+    }
+    if (name == "fuzzy") {
+        benchFuzzyLookup(count);
+        return 0;
+    }
+    if (name == "complete") {
+        benchCompletion(count);
+        return 0;
+    }
+#if defined(__linux__)
+    if (name == "server") {
+        benchServer(count);
+        return 0;
+    }
+#endif
+#if defined(WITH_SQLITE)
+    if (name == "sql") {
+        benchSql(count);
+        return 0;
+    }
+#endif
+    std::cout << "Unknown benchmark: " << name << "\n";
+    return 1;
+}
+
+// Display the menu and return a validated integer choice
+static int displayMenu() {
+    std::cout << "\n1. Load Data Structure.\n";
+    std::cout << "2. Print Course List.\n";
+    std::cout << "3. Print Course.\n";
+    std::cout << "4. Check Student Eligibility.\n";
+    std::cout << "5. Plan Terms.\n";
+    std::cout << "6. Print Prerequisite Closure.\n";
+    std::cout << "7. Edit Prerequisites.\n";
+    std::cout << "8. Export Catalog as JSON.\n";
+    std::cout << "9. Exit\n";
+    std::cout << "What would you like to do? ";
+
+    std::string input;
+    std::getline(std::cin, input);
+
+    input = trim(input);
+    if (input.empty()) {
+        return -1;
+    }
+
+    try {
+        return std::stoi(input);
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "--bench") {
+        size_t count = 100000;
+        if (argc >= 4) {
+            try {
+                count = static_cast<size_t>(std::stoul(argv[3]));
+            }
+            catch (...) {
+                std::cout << "Invalid course count: " << argv[3] << "\n";
+                return 1;
+            }
+        }
+        return runBenchmark(argv[2], count);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--export") {
+        const std::string format = argc >= 5 ? toUpper(argv[4]) : "JSON";
+        if (argc < 4 || (format != "JSON" && format != "NDJSON")) {
+            std::cout << "Usage: artifact1 --export <csvFile> <outputFile> [json|ndjson]\n";
+            return 1;
+        }
+        std::unordered_map<std::string, Course> loaded;
+        if (!loadCoursesFromCsv(argv[2], loaded)) {
+            std::cout << "Error: File not found or could not be opened\n";
+            return 1;
+        }
+        size_t exported = 0;
+        if (!exportCatalogJson(*buildCatalogSnapshot(std::move(loaded)), argv[3], format == "NDJSON", exported)) {
+            std::cout << "Error: Could not write " << argv[3] << "\n";
+            return 1;
+        }
+        std::cout << "Exported " << exported << " courses.\n";
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            std::cout << "Usage: artifact1 --batch <csvFile> [commandFile]\n";
+            return 1;
+        }
+        return runBatch(argv[2], argc >= 4 ? argv[3] : "");
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--sql") {
+#if defined(WITH_SQLITE)
+        if (argc < 3) {
+            std::cout << "Usage: artifact1 --sql <csvFile> [queryFile]\n";
+            return 1;
+        }
+        return runSql(argv[2], argc >= 4 ? argv[3] : "");
+#else
+        std::cout << "SQL mode requires building with -DWITH_SQLITE.\n";
+        return 1;
+#endif
+    }
+
+    if (argc >= 2 && (std::string(argv[1]) == "--serve" || std::string(argv[1]) == "--client")) {
+#if defined(__linux__)
+        if (std::string(argv[1]) == "--client" && argc >= 3) {
+            return runClient(argv[2]);
+        }
+        if (std::string(argv[1]) == "--serve" && argc >= 4) {
+            std::unordered_map<std::string, Course> loaded;
+            if (!loadCoursesFromCsv(argv[3], loaded)) {
+                std::cout << "Error: File not found or could not be opened\n";
+                return 1;
+            }
+            CatalogHolder served;
+            served.publish(buildCatalogSnapshot(std::move(loaded)));
+
+            std::signal(SIGINT, handleServerSignal);
+            std::signal(SIGTERM, handleServerSignal);
+            std::cout << "Serving " << served.read()->loaded->courses.size() << " courses on " << argv[2] << "\n";
+            const std::atomic<bool> stop{ false };
+            return runServer(argv[2], served, stop);
+        }
+        std::cout << "Usage: artifact1 --serve <socketPath> <csvFile> | --client <socketPath>\n";
+        return 1;
+#else
+        std::cout << "Server mode requires Linux.\n";
+        return 1;
+#endif
+    }
+
+    CatalogHolder catalog;
+    DynamicTopoOrder topo;
+    VisitMarks marks;
+    bool dataLoaded = false;
+
+    std::cout << "Welcome to the course planner.\n";
+
+    while (true) {
+        int choice = displayMenu();
+
+        switch (choice) {
+        case 1: {
+            std::cout << "Enter file name: ";
+            std::string filename;
+            std::getline(std::cin, filename);
+
+            std::unordered_map<std::string, Course> loaded;
+            if (!loadCoursesFromCsv(filename, loaded)) {
+                std::cout << "Error: File not found or could not be opened\n";
+                dataLoaded = false;
+            }
+            else {
+                catalog.publish(buildCatalogSnapshot(std::move(loaded)));
+
+                const auto snap = catalog.read();
+                topo.reset(snap->graph);
+                std::cout << "Data loaded successfully.\n";
+                if (snap->planner.hasCycle) {
+                    std::cout << "Warning: prerequisite cycle detected in catalog.\n";
+                }
+                dataLoaded = true;
+            }
+            break;
+        }
+        case 2:
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "Here is a sample schedule:\n";
+            printCourseList(*catalog.read());
+            break;
+
+        case 3: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "What course do you want to know about? ";
+            std::string courseNumber;
+            std::getline(std::cin, courseNumber);
+            const auto snap = catalog.read();
+            if (!printCourseDetails(snap->findCourse(toUpper(trim(courseNumber))))) {
+                printCourseSuggestions(*snap, courseNumber);
+            }
+            break;
+        }
+
+        case 4: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "Enter student file name: ";
+            std::string studentsFile;
+            std::getline(std::cin, studentsFile);
+            std::cout << "Enter output file name: ";
+            std::string outputFile;
+            std::getline(std::cin, outputFile);
+
+            const auto start = std::chrono::steady_clock::now();
+            WorkStealingPool pool(std::max(1u, std::thread::hardware_concurrency()));
+            size_t students = 0;
+            if (!runEligibilityBatch(catalog.read()->graph, trim(studentsFile), trim(outputFile), pool, students)) {
+                std::cout << "Error: File not found or could not be opened\n";
+                break;
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "Checked " << students << " students in " << elapsed.count() << " s.\n";
+            break;
+        }
+
+        case 5: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "Target courses: ";
+            std::string input;
+            std::getline(std::cin, input);
+            const std::vector<std::string> targets = parseCourseList(input);
+
+            std::cout << "Completed courses: ";
+            std::getline(std::cin, input);
+            const std::vector<std::string> completed = parseCourseList(input);
+
+            std::cout << "Maximum courses per term: ";
+            std::getline(std::cin, input);
+            size_t maxPerTerm = 0;
+            try {
+                maxPerTerm = static_cast<size_t>(std::stoul(trim(input)));
+            }
+            catch (...) {
+                maxPerTerm = 0;
+            }
+
+            std::vector<std::vector<std::string>> terms;
+            std::string error;
+            const auto snap = catalog.read();
+            if (!planTerms(snap->graph, snap->planner, targets, completed, maxPerTerm, marks, terms, error)) {
+                std::cout << "Error: " << error << "\n";
+                break;
+            }
+            if (terms.empty()) {
+                std::cout << "All target courses are already completed.\n";
+            }
+            for (size_t t = 0; t < terms.size(); ++t) {
+                std::cout << "Term " << (t + 1) << ": ";
+                for (size_t i = 0; i < terms[t].size(); ++i) {
+                    std::cout << terms[t][i];
+                    if (i + 1 < terms[t].size()) std::cout << ", ";
+                }
+                std::cout << "\n";
+            }
+            break;
+        }
+
+        case 6: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "What course do you want to know about? ";
+            std::string courseNumber;
+            std::getline(std::cin, courseNumber);
+            printPrerequisiteClosure(catalog.read()->graph, courseNumber);
+            break;
+        }
+
+        case 7: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            if (!topo.isValid()) {
+                std::cout << "Error: Catalog has a prerequisite cycle; reload a valid catalog first\n";
+                break;
+            }
+            std::cout << "Course to edit: ";
+            std::string courseNumber;
+            std::getline(std::cin, courseNumber);
+            courseNumber = toUpper(trim(courseNumber));
+
+            if (!catalog.read()->findCourse(courseNumber)) {
+                std::cout << "Error: Course not found\n";
+                break;
+            }
+
+            std::cout << "Add or remove a prerequisite (a/r)? ";
+            std::string action;
+            std::getline(std::cin, action);
+            action = toUpper(trim(action));
+
+            std::cout << "Prerequisite course: ";
+            std::string prereq;
+            std::getline(std::cin, prereq);
+            prereq = toUpper(trim(prereq));
+            if (prereq.empty()) {
+                std::cout << "Error: Prerequisite course is required\n";
+                break;
+            }
+
+            if (action != "A" && action != "R") {
+                std::cout << action << " is not a valid option.\n";
+                break;
+            }
+            if (action == "A" && !topo.addEdge(courseNumber, prereq)) {
+                std::cout << "Error: " << prereq << " already requires " << courseNumber
+                          << "; edit rejected to prevent a cycle\n";
+                break;
+            }
+
+            const bool add = action == "A";
+            if (!add) topo.removeEdge(courseNumber, prereq);
+
+            // The edit is patched into a copy of the current snapshot that
+            // shares everything it leaves alone. A course number the catalog
+            // has never seen needs new ids, so that edit publishes a rebuilt
+            // snapshot instead.
+            std::unique_ptr<CatalogSnapshot> patched =
+                patchPrerequisiteEdge(*catalog.read(), topo, marks, courseNumber, prereq, add);
+            if (patched) {
+                catalog.publish(std::move(patched));
+            }
+            else {
+                std::unordered_map<std::string, Course> edited = currentCourses(*catalog.read());
+                auto& list = edited.at(courseNumber).prerequisites;
+                if (!add) {
+                    list.erase(std::remove(list.begin(), list.end(), prereq), list.end());
+                }
+                else if (std::find(list.begin(), list.end(), prereq) == list.end()) {
+                    list.push_back(prereq);
+                }
+                catalog.publish(buildCatalogSnapshot(std::move(edited)));
+                topo.reset(catalog.read()->graph);
+            }
+            std::cout << "Prerequisites updated.\n";
+            break;
+        }
+
+        case 8: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "Enter output file name: ";
+            std::string outputFile;
+            std::getline(std::cin, outputFile);
+            std::cout << "Format (json/ndjson): ";
+            std::string format;
+            std::getline(std::cin, format);
+            format = toUpper(trim(format));
+            if (format != "JSON" && format != "NDJSON") {
+                std::cout << "Error: Format must be json or ndjson\n";
+                break;
+            }
+
+            size_t exported = 0;
+            if (!exportCatalogJson(*catalog.read(), trim(outputFile), format == "NDJSON", exported)) {
+                std::cout << "Error: Could not write " << trim(outputFile) << "\n";
+                break;
+            }
+            std::cout << "Exported " << exported << " courses.\n";
             break;
         }
 
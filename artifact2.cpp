@@ -1,11 +1,31 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <charconv>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 /*
 ========================================================
 Milestone Three: Algorithms and Data Structures Enhancement
@@ -19,6 +39,10 @@ Key enhancements:
 - Used in-order traversal to produce sorted output
 - Normalized input data to ensure consistent searching
 - Emphasized time/space trade-offs in data structure choice
+- Added a lock-free concurrent BST variant for multi-threaded readers
+- Added a persistent (path-copying) BST for versioned catalogs
+- In-order listings go through a buffered writer (one write per fill)
+- Added a streaming JSON/NDJSON export driven by in-order traversal
 
 These changes align this artifact with the Algorithms and
 Data Structures category of the CS-499 ePortfolio.
@@ -63,6 +87,169 @@ static std::string normalizeCourseNumber(const std::string& s) {
     return toUpper(trim(s));
 }
 
+/*
+--------------------------------------------------------
+Buffered output
+--------------------------------------------------------
+In-order traversal emits one short line per node. Pushing
+each field through operator<< makes a large listing
+iostream-bound, so lines are collected in one reusable
+buffer and handed to the OS with a single write(2) per
+buffer fill.
+*/
+class OutputBuffer {
+public:
+    // Writes to stdout
+    explicit OutputBuffer(size_t capacity = 1 << 20) : buf(capacity), used(0) {}
+
+    // Writes to a new or truncated file; check isOpen() before use
+    explicit OutputBuffer(const std::string& path, size_t capacity = 1 << 20) : buf(capacity), used(0) {
+#if defined(__linux__)
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        ok = fd >= 0;
+#else
+        file.open(path, std::ios::binary | std::ios::trunc);
+        toFile = true;
+        ok = file.is_open();
+#endif
+    }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer() {
+        flush();
+#if defined(__linux__)
+        if (fd != STDOUT_FILENO && fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool isOpen() const {
+#if defined(__linux__)
+        return fd >= 0;
+#else
+        return !toFile || file.is_open();
+#endif
+    }
+
+    void append(const char* data, size_t n) {
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                writeOut(data, n);
+                return;
+            }
+        }
+        std::memcpy(buf.data() + used, data, n);
+        used += n;
+    }
+
+    void append(const std::string& s) {
+        append(s.data(), s.size());
+    }
+
+    void append(char ch) {
+        if (used == buf.size()) flush();
+        buf[used++] = ch;
+    }
+
+    // Fast path for "<number>, <title>\n" listing lines: one capacity check
+    // and three copies.
+    void appendCourseLine(const char* number, size_t numberLen, const char* title, size_t titleLen) {
+        const size_t n = numberLen + titleLen + 3;
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                append(number, numberLen);
+                append(", ", 2);
+                append(title, titleLen);
+                append('\n');
+                return;
+            }
+        }
+        char* p = buf.data() + used;
+        std::memcpy(p, number, numberLen);
+        p += numberLen;
+        *p++ = ',';
+        *p++ = ' ';
+        std::memcpy(p, title, titleLen);
+        p[titleLen] = '\n';
+        used += n;
+    }
+
+    void appendCourseLine(const std::string& number, const std::string& title) {
+        appendCourseLine(number.data(), number.size(), title.data(), title.size());
+    }
+
+    // Direct access for serializers: returns room for n bytes at the end of
+    // the buffer (nullptr if n exceeds its capacity); commit() then records
+    // how many of them were written.
+    char* reserve(size_t n) {
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) return nullptr;
+        }
+        return buf.data() + used;
+    }
+
+    void commit(size_t n) {
+        used += n;
+    }
+
+    void appendUnsigned(uint64_t value) {
+        char digits[20];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    // Write out everything buffered so far. Returns false once any write
+    // has failed.
+    bool flush() {
+        if (used > 0) {
+            writeOut(buf.data(), used);
+            used = 0;
+        }
+        return ok;
+    }
+
+private:
+    std::vector<char> buf;
+    size_t used;
+    bool ok = true;
+#if defined(__linux__)
+    int fd = STDOUT_FILENO;
+#else
+    std::ofstream file;
+    bool toFile = false;
+#endif
+
+    void writeOut(const char* data, size_t n) {
+#if defined(__linux__)
+        if (fd < 0) return;
+        if (fd == STDOUT_FILENO) {
+            // Earlier std::cout output (menu text) must reach the fd first
+            std::cout.flush();
+            std::fflush(stdout);
+        }
+        while (n > 0) {
+            const ssize_t written = ::write(fd, data, n);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                return;
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+        }
+#else
+        std::ostream& os = toFile ? static_cast<std::ostream&>(file) : std::cout;
+        os.write(data, static_cast<std::streamsize>(n));
+        os.flush();
+        ok = ok && static_cast<bool>(os);
+#endif
+    }
+};
+
 /*
 --------------------------------------------------------
 Binary Search Tree Implementation
@@ -129,11 +316,19 @@ private:
     }
 
     // In-order traversal prints courses in sorted order
-    static void inOrderPrint(Node* node) {
+    static void inOrderPrint(Node* node, OutputBuffer& out) {
         if (!node) return;
-        inOrderPrint(node->left);
-        std::cout << node->data.courseNumber << ", " << node->data.title << "\n";
-        inOrderPrint(node->right);
+        inOrderPrint(node->left, out);
+        out.appendCourseLine(node->data.courseNumber, node->data.title);
+        inOrderPrint(node->right, out);
+    }
+
+    template <typename Visit>
+    static void inOrderVisit(const Node* node, Visit& visit) {
+        if (!node) return;
+        inOrderVisit(node->left, visit);
+        visit(node->data);
+        inOrderVisit(node->right, visit);
     }
 
 public:
@@ -155,7 +350,412 @@ public:
     }
 
     void printInOrder() const {
-        inOrderPrint(root);
+        OutputBuffer out;
+        inOrderPrint(root, out);
+    }
+
+    // Visit every course in sorted order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        inOrderVisit(root, visit);
+    }
+};
+
+/*
+--------------------------------------------------------
+Concurrent Binary Search Tree
+--------------------------------------------------------
+A thread-safe variant of CourseBST with the same insert
+and printInOrder interface. Many readers and occasional
+writers can use it at once without a global mutex:
+- Child links are atomic pointers. A new node is linked
+  with a single compare-and-swap on an empty child link,
+  so inserts are lock-free and a failed CAS simply
+  re-reads the link that another writer just filled.
+- Nodes are never unlinked while the tree is in use, so a
+  reader can follow any link it loads without validation.
+- Course data is immutable once published. Overwriting a
+  duplicate key swaps in a new copy and retires the old
+  one, which is freed once no reader can still hold it.
+Reclamation is epoch based, as in artifact1's catalog
+holder. A reader records the global epoch in its own
+slot for the length of one call; retiring bumps the
+epoch, and a retired copy is freed once every active
+slot shows a later epoch. search therefore hands the
+course to a callback, or copies it, instead of returning
+a pointer. Reads only write their own thread's slot,
+which is what lets read throughput scale with cores.
+clear() and destruction must not overlap with other
+operations.
+*/
+class ConcurrentCourseBST {
+public:
+    // Threads that may read at the same time. A thread beyond
+    // this limit waits for another reader thread to exit.
+    static constexpr size_t kMaxReaders = 256;
+
+private:
+    // Retired copies are reclaimed in batches of this size
+    static constexpr size_t kReclaimBatch = 64;
+
+    struct Node {
+        const std::string key;
+        std::atomic<const Course*> current;
+        std::atomic<Node*> left{ nullptr };
+        std::atomic<Node*> right{ nullptr };
+
+        explicit Node(const Course& c) : key(c.courseNumber), current(new Course(c)) {}
+
+        ~Node() {
+            delete current.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{ 0 };  // 0 = not reading
+        uint32_t depth = 0;                // nesting, touched only by the owner
+    };
+
+    // Holds the calling thread's slot for one read
+    class ReadScope {
+    public:
+        explicit ReadScope(const ConcurrentCourseBST& tree) : slot(tree.slots[readerIndex()]) {
+            if (slot.depth++ == 0) {
+                slot.epoch.store(tree.globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            }
+        }
+        ReadScope(const ReadScope&) = delete;
+        ReadScope& operator=(const ReadScope&) = delete;
+
+        ~ReadScope() {
+            if (--slot.depth == 0) slot.epoch.store(0, std::memory_order_release);
+        }
+
+    private:
+        Slot& slot;
+    };
+
+    std::atomic<Node*> root{ nullptr };
+    mutable Slot slots[kMaxReaders];
+    std::atomic<uint64_t> globalEpoch{ 1 };
+    mutable std::mutex retireMutex;
+    std::vector<std::pair<const Course*, uint64_t>> retired;
+
+    static void destroy(Node* node) {
+        if (!node) return;
+        destroy(node->left.load(std::memory_order_relaxed));
+        destroy(node->right.load(std::memory_order_relaxed));
+        delete node;
+    }
+
+    static void inOrderPrint(const Node* node, OutputBuffer& out) {
+        if (!node) return;
+        inOrderPrint(node->left.load(std::memory_order_acquire), out);
+        const Course& c = *node->current.load(std::memory_order_acquire);
+        out.appendCourseLine(c.courseNumber, c.title);
+        inOrderPrint(node->right.load(std::memory_order_acquire), out);
+    }
+
+    // Each thread claims one slot index for its lifetime, shared by
+    // all trees, and gives it back when the thread exits
+    static size_t readerIndex() {
+        static std::atomic<bool> claimed[kMaxReaders];
+
+        struct Claim {
+            size_t index = 0;
+            Claim() {
+                while (true) {
+                    for (size_t i = 0; i < kMaxReaders; ++i) {
+                        if (!claimed[i].exchange(true, std::memory_order_acquire)) {
+                            index = i;
+                            return;
+                        }
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            ~Claim() { claimed[index].store(false, std::memory_order_release); }
+        };
+
+        thread_local Claim claim;
+        return claim.index;
+    }
+
+    void retire(const Course* old) {
+        const uint64_t epoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::lock_guard<std::mutex> lock(retireMutex);
+        retired.emplace_back(old, epoch);
+        if (retired.size() >= kReclaimBatch) reclaimLocked();
+    }
+
+    size_t reclaimLocked() {
+        uint64_t oldestActive = std::numeric_limits<uint64_t>::max();
+        for (const Slot& s : slots) {
+            const uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+            if (e != 0) oldestActive = std::min(oldestActive, e);
+        }
+
+        size_t kept = 0;
+        for (const auto& r : retired) {
+            if (r.second <= oldestActive) {
+                delete r.first;
+            }
+            else {
+                retired[kept++] = r;
+            }
+        }
+        retired.resize(kept);
+        return kept;
+    }
+
+public:
+    ConcurrentCourseBST() = default;
+    ConcurrentCourseBST(const ConcurrentCourseBST&) = delete;
+    ConcurrentCourseBST& operator=(const ConcurrentCourseBST&) = delete;
+
+    ~ConcurrentCourseBST() {
+        clear();
+    }
+
+    void clear() {
+        destroy(root.exchange(nullptr, std::memory_order_acq_rel));
+        for (const auto& r : retired) {
+            delete r.first;
+        }
+        retired.clear();
+    }
+
+    // Iterative insert: walk to an empty link and CAS the new node in
+    void insert(const Course& course) {
+        Node* fresh = nullptr;
+        std::atomic<Node*>* link = &root;
+
+        while (true) {
+            Node* node = link->load(std::memory_order_acquire);
+            if (!node) {
+                if (!fresh) fresh = new Node(course);
+                if (link->compare_exchange_weak(node, fresh,
+                        std::memory_order_release, std::memory_order_acquire)) {
+                    return;
+                }
+                continue; // another writer linked a node here; compare against it
+            }
+
+            if (course.courseNumber < node->key) {
+                link = &node->left;
+            }
+            else if (course.courseNumber > node->key) {
+                link = &node->right;
+            }
+            else {
+                // Duplicate keys publish a new copy of the data
+                delete fresh;
+                const Course* old = node->current.exchange(new Course(course), std::memory_order_acq_rel);
+                retire(old);
+                return;
+            }
+        }
+    }
+
+    // Calls visit(const Course&) while the course is pinned, so a
+    // concurrent overwrite cannot free it. Returns false if the
+    // course is not in the tree.
+    template <typename Visit>
+    bool searchWith(const std::string& courseNumber, Visit visit) const {
+        const ReadScope scope(*this);
+        const Node* node = root.load(std::memory_order_acquire);
+        while (node) {
+            if (courseNumber == node->key) {
+                visit(*node->current.load(std::memory_order_acquire));
+                return true;
+            }
+            node = (courseNumber < node->key ? node->left : node->right).load(std::memory_order_acquire);
+        }
+        return false;
+    }
+
+    // Copies the course into out. Returns false if it is not in the tree.
+    bool search(const std::string& courseNumber, Course& out) const {
+        return searchWith(courseNumber, [&out](const Course& c) { out = c; });
+    }
+
+    void printInOrder() const {
+        const ReadScope scope(*this);
+        OutputBuffer out;
+        inOrderPrint(root.load(std::memory_order_acquire), out);
+    }
+
+    // Overwritten copies not yet freed. Stays below kReclaimBatch
+    // plus whatever readers still pin.
+    size_t retiredCopies() const {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        return retired.size();
+    }
+};
+
+/*
+--------------------------------------------------------
+Persistent Binary Search Tree
+--------------------------------------------------------
+An immutable, versioned variant of CourseBST. insert and
+erase never modify existing nodes; they copy only the
+O(log n) nodes on the path to the changed key and return
+a new tree whose untouched subtrees are shared with the
+old one. Every older root stays valid, so "catalog as of
+last fall" and "catalog as of this term" can be queried
+side by side for little more memory than one copy.
+
+Nodes are reference counted through shared_ptr, so a
+subtree is freed when the last version using it goes
+away. Because nothing reachable from a root ever changes,
+any number of threads can read a version concurrently
+without synchronization.
+
+Trees are built balanced from sorted input (fromSorted),
+and later versions are usually small diffs of an earlier
+one, which keeps paths short without rebalancing.
+*/
+class PersistentCourseBST {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        Course data;
+        NodePtr left;
+        NodePtr right;
+
+        Node(const Course& c, NodePtr l, NodePtr r)
+            : data(c), left(std::move(l)), right(std::move(r)) {}
+    };
+
+    NodePtr root;
+    size_t count = 0;
+
+    PersistentCourseBST(NodePtr r, size_t n) : root(std::move(r)), count(n) {}
+
+    static NodePtr build(const std::vector<Course>& sorted, size_t lo, size_t hi) {
+        if (lo >= hi) return nullptr;
+        const size_t mid = lo + (hi - lo) / 2;
+        return std::make_shared<const Node>(sorted[mid],
+            build(sorted, lo, mid), build(sorted, mid + 1, hi));
+    }
+
+    // Path-copying insert. Sets added when the key was not present.
+    static NodePtr insert(const NodePtr& node, const Course& course, bool& added) {
+        if (!node) {
+            added = true;
+            return std::make_shared<const Node>(course, nullptr, nullptr);
+        }
+        if (course.courseNumber < node->data.courseNumber) {
+            return std::make_shared<const Node>(node->data, insert(node->left, course, added), node->right);
+        }
+        if (course.courseNumber > node->data.courseNumber) {
+            return std::make_shared<const Node>(node->data, node->left, insert(node->right, course, added));
+        }
+        // Duplicate keys overwrite existing data
+        return std::make_shared<const Node>(course, node->left, node->right);
+    }
+
+    // Path-copying delete. Sets removed when the key was present.
+    static NodePtr erase(const NodePtr& node, const std::string& key, bool& removed) {
+        if (!node) return nullptr;
+
+        if (key < node->data.courseNumber) {
+            NodePtr left = erase(node->left, key, removed);
+            return removed ? std::make_shared<const Node>(node->data, left, node->right) : node;
+        }
+        if (key > node->data.courseNumber) {
+            NodePtr right = erase(node->right, key, removed);
+            return removed ? std::make_shared<const Node>(node->data, node->left, right) : node;
+        }
+
+        removed = true;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+
+        // Two children: replace with the in-order successor
+        const Node* successor = node->right.get();
+        while (successor->left) successor = successor->left.get();
+        bool unused = false;
+        return std::make_shared<const Node>(successor->data, node->left,
+            erase(node->right, successor->data.courseNumber, unused));
+    }
+
+    static void inOrderPrint(const Node* node, OutputBuffer& out) {
+        if (!node) return;
+        inOrderPrint(node->left.get(), out);
+        out.appendCourseLine(node->data.courseNumber, node->data.title);
+        inOrderPrint(node->right.get(), out);
+    }
+
+    template <typename Visit>
+    static void inOrderVisit(const Node* node, Visit& visit) {
+        if (!node) return;
+        inOrderVisit(node->left.get(), visit);
+        visit(node->data);
+        inOrderVisit(node->right.get(), visit);
+    }
+
+    static void collectNodes(const Node* node, std::unordered_set<const Node*>& out) {
+        if (!node || !out.insert(node).second) return;
+        collectNodes(node->left.get(), out);
+        collectNodes(node->right.get(), out);
+    }
+
+public:
+    PersistentCourseBST() = default;
+
+    // Builds a balanced tree from courses sorted by course number
+    static PersistentCourseBST fromSorted(const std::vector<Course>& sorted) {
+        return PersistentCourseBST(build(sorted, 0, sorted.size()), sorted.size());
+    }
+
+    PersistentCourseBST insert(const Course& course) const {
+        bool added = false;
+        NodePtr r = insert(root, course, added);
+        return PersistentCourseBST(std::move(r), count + (added ? 1 : 0));
+    }
+
+    PersistentCourseBST erase(const std::string& courseNumber) const {
+        bool removed = false;
+        NodePtr r = erase(root, courseNumber, removed);
+        return PersistentCourseBST(std::move(r), count - (removed ? 1 : 0));
+    }
+
+    const Course* search(const std::string& courseNumber) const {
+        const Node* node = root.get();
+        while (node) {
+            if (courseNumber == node->data.courseNumber) return &node->data;
+            node = (courseNumber < node->data.courseNumber ? node->left : node->right).get();
+        }
+        return nullptr;
+    }
+
+    void printInOrder() const {
+        OutputBuffer out;
+        inOrderPrint(root.get(), out);
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        inOrderVisit(root.get(), visit);
+    }
+
+    size_t size() const { return count; }
+
+    // Number of this tree's nodes that are physically shared with other
+    size_t sharedNodesWith(const PersistentCourseBST& other) const {
+        std::unordered_set<const Node*> theirs;
+        collectNodes(other.root.get(), theirs);
+        std::unordered_set<const Node*> mine;
+        collectNodes(root.get(), mine);
+
+        size_t shared = 0;
+        for (const Node* n : mine) {
+            if (theirs.count(n)) ++shared;
+        }
+        return shared;
     }
 };
 
@@ -167,6 +767,32 @@ Reads course data from a CSV file and inserts each course
 into the BST. Data normalization ensures correct ordering
 and searching within the tree.
 */
+// Parses one CSV line into a normalized course.
+// Returns false for blank or malformed lines.
+static bool parseCourseLine(const std::string& rawLine, Course& out) {
+    const std::string line = trim(rawLine);
+    if (line.empty()) return false;
+
+    std::istringstream ss(line);
+    std::string courseNumber, title;
+
+    if (!std::getline(ss, courseNumber, ',')) return false;
+    if (!std::getline(ss, title, ',')) return false;
+
+    out.courseNumber = normalizeCourseNumber(courseNumber);
+    out.title = trim(title);
+    out.prerequisites.clear();
+
+    std::string prereq;
+    while (std::getline(ss, prereq, ',')) {
+        prereq = normalizeCourseNumber(prereq);
+        if (!prereq.empty()) {
+            out.prerequisites.push_back(prereq);
+        }
+    }
+    return true;
+}
+
 static bool loadCoursesFromCsv(const std::string& fileName, CourseBST& bstOut) {
     std::ifstream file(fileName);
     if (!file.is_open()) {
@@ -176,31 +802,89 @@ static bool loadCoursesFromCsv(const std::string& fileName, CourseBST& bstOut) {
     bstOut.clear();
 
     std::string line;
+    Course c;
     while (std::getline(file, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
+        if (parseCourseLine(line, c)) {
+            bstOut.insert(c);
+        }
+    }
+
+    return true;
+}
 
-        std::istringstream ss(line);
-        std::string courseNumber, title;
+/*
+--------------------------------------------------------
+Versioned Catalog Loading
+--------------------------------------------------------
+Builds a new persistent version from a CSV file. The first
+version is built balanced from the sorted records. Later
+versions start from the previous version and apply only
+the differences: changed or new courses are inserted and
+courses missing from the file are erased, so unchanged
+subtrees are shared between versions.
+*/
+static bool sameCourse(const Course& a, const Course& b) {
+    return a.courseNumber == b.courseNumber && a.title == b.title &&
+        a.prerequisites == b.prerequisites;
+}
 
-        if (!std::getline(ss, courseNumber, ',')) continue;
-        if (!std::getline(ss, title, ',')) continue;
+static bool loadCourseVersionFromCsv(const std::string& fileName,
+    const PersistentCourseBST* previous, PersistentCourseBST& versionOut) {
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        return false;
+    }
 
-        Course c;
-        c.courseNumber = normalizeCourseNumber(courseNumber);
-        c.title = trim(title);
+    std::vector<Course> courses;
+    std::string line;
+    Course c;
+    while (std::getline(file, line)) {
+        if (parseCourseLine(line, c)) {
+            courses.push_back(c);
+        }
+    }
 
-        std::string prereq;
-        while (std::getline(ss, prereq, ',')) {
-            prereq = normalizeCourseNumber(prereq);
-            if (!prereq.empty()) {
-                c.prerequisites.push_back(prereq);
-            }
+    // Sort by course number; for duplicates the later record wins
+    std::stable_sort(courses.begin(), courses.end(), [](const Course& a, const Course& b) {
+        return a.courseNumber < b.courseNumber;
+    });
+    std::vector<Course> latest;
+    for (auto& course : courses) {
+        if (!latest.empty() && latest.back().courseNumber == course.courseNumber) {
+            latest.back() = std::move(course);
         }
+        else {
+            latest.push_back(std::move(course));
+        }
+    }
+
+    if (!previous) {
+        versionOut = PersistentCourseBST::fromSorted(latest);
+        return true;
+    }
+
+    PersistentCourseBST next = *previous;
+    for (const auto& course : latest) {
+        const Course* existing = next.search(course.courseNumber);
+        if (!existing || !sameCourse(*existing, course)) {
+            next = next.insert(course);
+        }
+    }
 
-        bstOut.insert(c);
+    // Both sequences are sorted, so removed courses fall out of a merge walk
+    std::vector<std::string> removed;
+    size_t i = 0;
+    previous->forEach([&](const Course& old) {
+        while (i < latest.size() && latest[i].courseNumber < old.courseNumber) ++i;
+        if (i == latest.size() || latest[i].courseNumber != old.courseNumber) {
+            removed.push_back(old.courseNumber);
+        }
+    });
+    for (const auto& key : removed) {
+        next = next.erase(key);
     }
 
+    versionOut = next;
     return true;
 }
 
@@ -209,30 +893,373 @@ static bool loadCoursesFromCsv(const std::string& fileName, CourseBST& bstOut) {
 Course Detail Output
 --------------------------------------------------------
 Uses BST search to retrieve a specific course in
-average O(log n) time.
+average O(log n) time. Works with any of the tree
+variants, since they share the same search interface.
 */
-static void printCourseDetails(const CourseBST& bst, std::string courseNumber) {
+template <typename Tree>
+static void printCourseDetails(const Tree& bst, std::string courseNumber) {
     courseNumber = normalizeCourseNumber(courseNumber);
 
+    // A detail block is a few lines; the buffer only needs room for one
+    OutputBuffer out(4096);
     const Course* c = bst.search(courseNumber);
     if (!c) {
-        std::cout << "Error: Course not found\n";
+        out.append("Error: Course not found\n", 24);
         return;
     }
 
-    std::cout << c->courseNumber << ", " << c->title << "\n";
-    std::cout << "Prerequisites: ";
+    out.appendCourseLine(c->courseNumber, c->title);
+    out.append("Prerequisites: ", 15);
 
     if (c->prerequisites.empty()) {
-        std::cout << "None\n";
+        out.append("None\n", 5);
         return;
     }
 
     for (size_t i = 0; i < c->prerequisites.size(); ++i) {
-        std::cout << c->prerequisites[i];
-        if (i + 1 < c->prerequisites.size()) std::cout << ", ";
+        out.append(c->prerequisites[i]);
+        if (i + 1 < c->prerequisites.size()) out.append(", ", 2);
+    }
+    out.append('\n');
+}
+
+/*
+--------------------------------------------------------
+JSON Export
+--------------------------------------------------------
+Streams a tree as JSON or NDJSON straight into a buffered
+writer on the target file. In-order traversal visits the
+courses sorted, and each one is written as soon as it is
+visited, so no document is built in memory:
+  {"courseNumber":"CS310","title":"...","prerequisites":[...]}
+*/
+// Escape action per byte: 0 copies the byte as-is, 'u' writes \u00XX, and
+// anything else is the letter after the backslash. Bytes >= 0x80 pass
+// through, so UTF-8 titles are emitted unchanged.
+static const std::array<char, 256> kJsonEscape = []() {
+    std::array<char, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = 'u';
+    }
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+}();
+
+// True if any of the 8 bytes in w is a control byte, '"' or '\\'
+static bool jsonEscapeInWord(uint64_t w) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    const uint64_t quote = w ^ (ones * '"');
+    const uint64_t backslash = w ^ (ones * '\\');
+    return (((w - ones * 0x20) & ~w) | ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash)) & highs;
+}
+
+// Quote and escape a string straight into the output buffer. Clean 8-byte
+// blocks are copied whole; only blocks holding a byte to escape are walked
+// byte by byte.
+static void appendJsonString(OutputBuffer& out, const char* s, size_t n) {
+    static const char kHex[] = "0123456789abcdef";
+
+    char* const start = out.reserve(n * 6 + 2);
+    if (!start) {
+        // Longer than the whole buffer: escape one byte at a time
+        out.append('"');
+        for (size_t i = 0; i < n; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(s[i]);
+            const char esc = kJsonEscape[ch];
+            if (esc == 0) {
+                out.append(s[i]);
+            }
+            else if (esc == 'u') {
+                const char hex[6] = { '\\', 'u', '0', '0', kHex[ch >> 4], kHex[ch & 0xF] };
+                out.append(hex, sizeof(hex));
+            }
+            else {
+                const char pair[2] = { '\\', esc };
+                out.append(pair, sizeof(pair));
+            }
+        }
+        out.append('"');
+        return;
+    }
+
+    char* p = start;
+    *p++ = '"';
+    size_t i = 0;
+    while (i < n) {
+        if (i + 8 <= n) {
+            uint64_t w;
+            std::memcpy(&w, s + i, 8);
+            if (!jsonEscapeInWord(w)) {
+                std::memcpy(p, s + i, 8);
+                p += 8;
+                i += 8;
+                continue;
+            }
+        }
+        const size_t blockEnd = std::min(n, i + 8);
+        for (; i < blockEnd; ++i) {
+            const unsigned char ch = static_cast<unsigned char>(s[i]);
+            const char esc = kJsonEscape[ch];
+            if (esc == 0) {
+                *p++ = s[i];
+            }
+            else if (esc == 'u') {
+                *p++ = '\\';
+                *p++ = 'u';
+                *p++ = '0';
+                *p++ = '0';
+                *p++ = kHex[ch >> 4];
+                *p++ = kHex[ch & 0xF];
+            }
+            else {
+                *p++ = '\\';
+                *p++ = esc;
+            }
+        }
+    }
+    *p++ = '"';
+    out.commit(static_cast<size_t>(p - start));
+}
+
+// Frames courses as either one JSON document
+//   {"courses":[{...},{...}],"count":N}
+// or NDJSON, one course object per line. Courses are written as they are
+// visited; nothing is collected first.
+class JsonCatalogWriter {
+public:
+    JsonCatalogWriter(OutputBuffer& out, bool ndjson) : out(out), ndjson(ndjson) {
+        if (!ndjson) out.append("{\"courses\":[", 12);
+    }
+
+    void beginCourse(const char* number, size_t numberLen, const char* title, size_t titleLen) {
+        if (!ndjson && written > 0) out.append(',');
+        if (!ndjson) out.append('\n');
+        out.append("{\"courseNumber\":", 16);
+        appendJsonString(out, number, numberLen);
+        out.append(",\"title\":", 9);
+        appendJsonString(out, title, titleLen);
+        out.append(",\"prerequisites\":[", 18);
+        prereqs = 0;
+    }
+
+    void prerequisite(const char* number, size_t numberLen) {
+        if (prereqs++ > 0) out.append(',');
+        appendJsonString(out, number, numberLen);
+    }
+
+    void endCourse() {
+        out.append("]}", 2);
+        if (ndjson) out.append('\n');
+        ++written;
+    }
+
+    void course(const Course& c) {
+        beginCourse(c.courseNumber.data(), c.courseNumber.size(), c.title.data(), c.title.size());
+        for (const auto& p : c.prerequisites) {
+            prerequisite(p.data(), p.size());
+        }
+        endCourse();
+    }
+
+    // Close the document and flush. Returns false if any write failed.
+    bool finish() {
+        if (!ndjson) {
+            out.append("\n],\"count\":", 11);
+            out.appendUnsigned(written);
+            out.append("}\n", 2);
+        }
+        return out.flush();
+    }
+
+    size_t count() const { return written; }
+
+private:
+    OutputBuffer& out;
+    bool ndjson;
+    size_t written = 0;
+    size_t prereqs = 0;
+};
+
+template <typename Tree>
+static bool exportCatalogJson(const Tree& bst, const std::string& path, bool ndjson, size_t& countOut) {
+    OutputBuffer out(path);
+    if (!out.isOpen()) {
+        return false;
+    }
+
+    JsonCatalogWriter writer(out, ndjson);
+    bst.forEach([&writer](const Course& c) { writer.course(c); });
+    countOut = writer.count();
+    return writer.finish();
+}
+
+/*
+--------------------------------------------------------
+Benchmarks
+--------------------------------------------------------
+Run with: artifact2 --bench <name> [courseCount]
+Benchmarks use generated course numbers inserted in a
+shuffled order so the unbalanced BST stays shallow.
+*/
+static std::string syntheticCourseNumber(size_t i) {
+    std::string digits = std::to_string(i);
+    return "C" + std::string(digits.size() < 7 ? 7 - digits.size() : 0, '0') + digits;
+}
+
+static Course syntheticCourse(size_t i) {
+    Course c;
+    c.courseNumber = syntheticCourseNumber(i);
+    c.title = "Generated Course " + std::to_string(i);
+    return c;
+}
+
+// Shuffled 0..count-1 using a fixed xorshift seed
+static std::vector<size_t> shuffledIndexes(size_t count, uint64_t seed) {
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    for (size_t i = count; i > 1; --i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        std::swap(order[i - 1], order[seed % i]);
+    }
+    return order;
+}
+
+// Runs `readers` search threads against the tree while one updater thread
+// keeps inserting new courses and overwriting existing ones. Returns total
+// searches per second across all readers.
+template <typename Search, typename Insert>
+static double measureReadThroughput(size_t readers, size_t count, Search search, Insert insert) {
+    using Clock = std::chrono::steady_clock;
+    const size_t searchesPerReader = 1000000;
+
+    std::atomic<bool> done{ false };
+    std::thread updater([&]() {
+        size_t next = count;
+        while (!done.load(std::memory_order_relaxed)) {
+            insert(syntheticCourse(next % 2 ? next : next % count));
+            ++next;
+        }
+    });
+
+    std::atomic<size_t> hits{ 0 };
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t]() {
+            uint64_t state = 0x9E3779B97F4A7C15ULL + t;
+            size_t found = 0;
+            std::string key;
+            for (size_t i = 0; i < searchesPerReader; ++i) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                key = syntheticCourseNumber(state % count);
+                if (search(key)) ++found;
+            }
+            hits += found;
+        });
+    }
+    for (auto& th : threads) th.join();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    done = true;
+    updater.join();
+
+    if (hits.load() != readers * searchesPerReader) {
+        std::cout << "Warning: " << readers * searchesPerReader - hits.load() << " searches missed\n";
+    }
+    return static_cast<double>(readers * searchesPerReader) / elapsed.count();
+}
+
+// Concurrent BST versus the original CourseBST behind a reader/writer lock
+static void benchConcurrentReads(size_t count) {
+    const std::vector<size_t> order = shuffledIndexes(count, 88172645463325252ULL);
+
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t <= maxThreads; t *= 2) threadCounts.push_back(t);
+    if (threadCounts.back() != maxThreads) threadCounts.push_back(maxThreads);
+
+    std::cout << "Courses: " << count << ", one background updater\n";
+    std::cout << "Readers  Locked BST (searches/s)  Concurrent BST (searches/s)  Retired copies held\n";
+    for (size_t readers : threadCounts) {
+        CourseBST locked;
+        std::shared_mutex lock;
+        ConcurrentCourseBST concurrent;
+        for (size_t i : order) {
+            locked.insert(syntheticCourse(i));
+            concurrent.insert(syntheticCourse(i));
+        }
+
+        const double lockedRate = measureReadThroughput(readers, count,
+            [&](const std::string& key) {
+                std::shared_lock<std::shared_mutex> guard(lock);
+                return locked.search(key) != nullptr;
+            },
+            [&](const Course& c) {
+                std::unique_lock<std::shared_mutex> guard(lock);
+                locked.insert(c);
+            });
+
+        const double concurrentRate = measureReadThroughput(readers, count,
+            [&](const std::string& key) { return concurrent.searchWith(key, [](const Course&) {}); },
+            [&](const Course& c) { concurrent.insert(c); });
+
+        // Copies the updater overwrote are freed in batches while the
+        // readers run, so this stays small however long the run was
+        std::cout << std::setw(7) << readers << "  " << std::setw(24) << lockedRate
+                  << "  " << std::setw(27) << concurrentRate
+                  << "  " << std::setw(19) << concurrent.retiredCopies() << "\n";
+    }
+}
+
+// JSON and NDJSON export throughput to a scratch file in the
+// working directory, which is removed afterwards
+static void benchExport(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    const std::string path = "bench_export.json";
+
+    CourseBST bst;
+    for (size_t i : shuffledIndexes(count, 88172645463325252ULL)) {
+        bst.insert(syntheticCourse(i));
+    }
+    std::cout << "Courses: " << count << "\n";
+
+    for (const bool ndjson : { false, true }) {
+        size_t exported = 0;
+        const auto start = Clock::now();
+        const bool ok = exportCatalogJson(bst, path, ndjson, exported);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::ifstream written(path, std::ios::binary | std::ios::ate);
+        const double megabytes = static_cast<double>(written.tellg()) / (1024.0 * 1024.0);
+        std::cout << (ndjson ? "NDJSON: " : "JSON:   ") << (ok ? "" : "(write failed) ")
+                  << megabytes << " MB in " << elapsed.count() * 1e3 << " ms ("
+                  << megabytes / elapsed.count() << " MB/s)\n";
+    }
+    std::remove(path.c_str());
+}
+
+static int runBenchmark(const std::string& name, size_t count) {
+    if (name == "concurrent") {
+        benchConcurrentReads(count);
+        return 0;
+    }
+    if (name == "export") {
+        benchExport(count);
+        return 0;
     }
-    std::cout << "\n";
+    std::cout << "Unknown benchmark: " << name << "\n";
+    return 1;
 }
 
 /*
@@ -246,6 +1273,9 @@ static int displayMenu() {
     std::cout << "\n1. Load Data Structure.\n";
     std::cout << "2. Print Course List.\n";
     std::cout << "3. Print Course.\n";
+    std::cout << "4. Load Catalog Version.\n";
+    std::cout << "5. Print Course From Version.\n";
+    std::cout << "6. Export Catalog as JSON.\n";
     std::cout << "9. Exit\n";
     std::cout << "What would you like to do? ";
 
@@ -263,10 +1293,28 @@ static int displayMenu() {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "--bench") {
+        size_t count = 100000;
+        if (argc >= 4) {
+            try {
+                count = static_cast<size_t>(std::stoul(argv[3]));
+            }
+            catch (...) {
+                std::cout << "Invalid course count: " << argv[3] << "\n";
+                return 1;
+            }
+        }
+        return runBenchmark(argv[2], count);
+    }
+
     CourseBST bst;
     bool dataLoaded = false;
 
+    // Named catalog versions, oldest first. Each one shares unchanged
+    // subtrees with the version loaded before it.
+    std::vector<std::pair<std::string, PersistentCourseBST>> versions;
+
     std::cout << "Welcome to the course planner.\n";
 
     while (true) {
@@ -308,6 +1356,90 @@ int main() {
             printCourseDetails(bst, courseNumber);
             break;
         }
+        case 4: {
+            std::cout << "Version name: ";
+            std::string name;
+            std::getline(std::cin, name);
+            name = trim(name);
+            if (name.empty()) {
+                std::cout << "Error: Version name is required\n";
+                break;
+            }
+
+            std::cout << "Enter file name: ";
+            std::string filename;
+            std::getline(std::cin, filename);
+
+            const PersistentCourseBST* previous = versions.empty() ? nullptr : &versions.back().second;
+            PersistentCourseBST version;
+            if (!loadCourseVersionFromCsv(filename, previous, version)) {
+                std::cout << "Error: File not found or could not be opened\n";
+                break;
+            }
+
+            std::cout << "Version " << name << " loaded: " << version.size() << " courses";
+            if (previous) {
+                std::cout << ", " << version.sharedNodesWith(*previous)
+                          << " nodes shared with version " << versions.back().first;
+            }
+            std::cout << "\n";
+
+            const auto existing = std::find_if(versions.begin(), versions.end(),
+                [&](const std::pair<std::string, PersistentCourseBST>& v) { return v.first == name; });
+            if (existing != versions.end()) {
+                versions.erase(existing);
+            }
+            versions.emplace_back(name, version);
+            break;
+        }
+        case 5: {
+            if (versions.empty()) {
+                std::cout << "Please load a catalog version first using option 4.\n";
+                break;
+            }
+            std::cout << "Version name: ";
+            std::string name;
+            std::getline(std::cin, name);
+            name = trim(name);
+
+            const auto it = std::find_if(versions.begin(), versions.end(),
+                [&](const std::pair<std::string, PersistentCourseBST>& v) { return v.first == name; });
+            if (it == versions.end()) {
+                std::cout << "Error: Version not found\n";
+                break;
+            }
+
+            std::cout << "What course do you want to know about? ";
+            std::string courseNumber;
+            std::getline(std::cin, courseNumber);
+            printCourseDetails(it->second, courseNumber);
+            break;
+        }
+        case 6: {
+            if (!dataLoaded) {
+                std::cout << "Please load data first using option 1.\n";
+                break;
+            }
+            std::cout << "Enter output file name: ";
+            std::string outputFile;
+            std::getline(std::cin, outputFile);
+            std::cout << "Format (json/ndjson): ";
+            std::string format;
+            std::getline(std::cin, format);
+            format = toUpper(trim(format));
+            if (format != "JSON" && format != "NDJSON") {
+                std::cout << "Error: Format must be json or ndjson\n";
+                break;
+            }
+
+            size_t exported = 0;
+            if (!exportCatalogJson(bst, trim(outputFile), format == "NDJSON", exported)) {
+                std::cout << "Error: Could not write " << trim(outputFile) << "\n";
+                break;
+            }
+            std::cout << "Exported " << exported << " courses.\n";
+            break;
+        }
         case 9:
             std::cout << "Thank you for using the course planner!\n";
             return 0;
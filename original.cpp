@@ -4,6 +4,13 @@
 #include <sstream>
 #include <string>
 #include <algorithm>  // For std::sort
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <unistd.h>  // For write(2)
+#endif
 
 // Define the Course class that will hold course details
 class Course {
@@ -60,48 +67,159 @@ std::vector<Course> parseFile(std::ifstream& file) {
     return courseList;  // Return the vector containing all courses
 }
 
+// Output sink that collects printed lines in one reusable buffer and writes
+// them with a single write(2) per buffer fill instead of flushing every line
+class OutputBuffer {
+public:
+    explicit OutputBuffer(size_t capacity = 1 << 20) : buf(capacity), used(0) {}
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer() {
+        flush();
+    }
+
+    void append(const char* data, size_t n) {
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                writeOut(data, n);
+                return;
+            }
+        }
+        std::memcpy(buf.data() + used, data, n);
+        used += n;
+    }
+
+    void append(const std::string& s) {
+        append(s.data(), s.size());
+    }
+
+    void append(char ch) {
+        if (used == buf.size()) flush();
+        buf[used++] = ch;
+    }
+
+    // Fast path for "<number>, <title>\n" listing lines: one capacity check
+    // and three copies.
+    void appendCourseLine(const char* number, size_t numberLen, const char* title, size_t titleLen) {
+        const size_t n = numberLen + titleLen + 3;
+        if (n > buf.size() - used) {
+            flush();
+            if (n > buf.size()) {
+                append(number, numberLen);
+                append(", ", 2);
+                append(title, titleLen);
+                append('\n');
+                return;
+            }
+        }
+        char* p = buf.data() + used;
+        std::memcpy(p, number, numberLen);
+        p += numberLen;
+        *p++ = ',';
+        *p++ = ' ';
+        std::memcpy(p, title, titleLen);
+        p[titleLen] = '\n';
+        used += n;
+    }
+
+    void appendCourseLine(const std::string& number, const std::string& title) {
+        appendCourseLine(number.data(), number.size(), title.data(), title.size());
+    }
+
+    // Write out everything buffered so far. Returns false once any write
+    // has failed.
+    bool flush() {
+        if (used > 0) {
+            writeOut(buf.data(), used);
+            used = 0;
+        }
+        return ok;
+    }
+
+private:
+    std::vector<char> buf;
+    size_t used;
+    bool ok = true;
+
+    void writeOut(const char* data, size_t n) {
+        // Earlier std::cout output (menu text) must reach the fd first
+        std::cout.flush();
+#if defined(__linux__)
+        std::fflush(stdout);
+        while (n > 0) {
+            const ssize_t written = ::write(STDOUT_FILENO, data, n);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                return;
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+        }
+#else
+        std::cout.write(data, static_cast<std::streamsize>(n));
+        std::cout.flush();
+        ok = ok && static_cast<bool>(std::cout);
+#endif
+    }
+};
+
 // Function to print the sorted list of courses
-void printSortedCourses(const std::vector<Course>& courses) {
-    std::vector<Course> sortedCourses = courses;  // Create a copy of the courses vector to sort
-    std::sort(sortedCourses.begin(), sortedCourses.end(), [](const Course& a, const Course& b) {
-        // Compare course numbers to sort the courses in ascending order
-        return a.courseNumber < b.courseNumber;
-        });
+// sortedOrder caches the sorted positions of the courses; it is built on the first
+// listing after a load and must be cleared whenever the courses are reloaded
+void printSortedCourses(const std::vector<Course>& courses, std::vector<size_t>& sortedOrder) {
+    if (sortedOrder.size() != courses.size()) {
+        sortedOrder.resize(courses.size());
+        for (size_t i = 0; i < courses.size(); ++i) {
+            sortedOrder[i] = i;  // Sort positions instead of copying the courses
+        }
+        std::sort(sortedOrder.begin(), sortedOrder.end(), [&courses](size_t a, size_t b) {
+            // Compare course numbers to sort the courses in ascending order
+            return courses[a].courseNumber < courses[b].courseNumber;
+            });
+    }
 
     // Print the sorted list of courses
-    for (const auto& course : sortedCourses) {
-        std::cout << course.courseNumber << ", " << course.title << std::endl;  // Print course number and title
+    OutputBuffer out;  // Written out when it goes out of scope
+    for (size_t index : sortedOrder) {
+        const Course& course = courses[index];
+        out.appendCourseLine(course.courseNumber, course.title);  // Print course number and title
     }
 }
 
 // Function to search for a specific course by its course number
 void searchCourse(const std::string& courseNumber, const std::vector<Course>& courses) {
+    OutputBuffer out(4096);  // A few lines at most; written out when it goes out of scope
     for (const auto& course : courses) {
         if (course.courseNumber == courseNumber) {  // If the course number matches exactly
-            std::cout << course.courseNumber << ", " << course.title << std::endl;  // Print the course details
-            std::cout << "Prerequisites: ";
+            out.appendCourseLine(course.courseNumber, course.title);  // Print the course details
+            out.append("Prerequisites: ", 15);
             if (course.prerequisites.empty()) {  // If no prerequisites, print "None"
-                std::cout << "None" << std::endl;
+                out.append("None\n", 5);
             }
             else {  // Otherwise, print each prerequisite
                 for (const auto& prereq : course.prerequisites) {
-                    std::cout << prereq << " ";
+                    out.append(prereq);
+                    out.append(' ');
                 }
-                std::cout << std::endl;
+                out.append('\n');
             }
             return;  // Exit the function once the course is found
         }
     }
-    std::cout << "Error: Course not found" << std::endl;  // If no course is found, print an error message
+    out.append("Error: Course not found\n", 24);  // If no course is found, print an error message
 }
 
 // Function to display the main menu and prompt the user for their choice
 int displayMenu() {
     // Print the available options to the user
-    std::cout << "1. Load Data Structure." << std::endl;
-    std::cout << "2. Print Course List." << std::endl;
-    std::cout << "3. Print Course." << std::endl;
-    std::cout << "9. Exit" << std::endl;
+    std::cout << "1. Load Data Structure.\n";
+    std::cout << "2. Print Course List.\n";
+    std::cout << "3. Print Course.\n";
+    std::cout << "9. Exit\n";
     std::cout << "What would you like to do? ";  // Prompt user for input
 
     int choice;
@@ -112,11 +230,12 @@ int displayMenu() {
 int main() {
     std::string filename = "CS 300 ABCU_Advising_Program_Input.csv";  // Default file path to the course data CSV file
     std::vector<Course> courses;  // Vector to store courses
+    std::vector<size_t> sortedOrder;  // Cached sorted listing order, rebuilt after each load
     std::ifstream file = openFile(filename);  // Open the file
 
     courses = parseFile(file);  // Parse the file and load courses into the vector
 
-    std::cout << "Welcome to the course planner." << std::endl;
+    std::cout << "Welcome to the course planner.\n";
 
     // Main program loop to keep displaying the menu until the user exits
     while (true) {
@@ -128,10 +247,11 @@ int main() {
             std::cin >> filename;  // Prompt the user to enter the file name
             file = openFile(filename);  // Open the new file
             courses = parseFile(file);  // Parse the new file and load the courses
+            sortedOrder.clear();  // Invalidate the cached listing order
             break;
         case 2:  // Option to print the sorted course list
-            std::cout << "Here is a sample schedule:" << std::endl;
-            printSortedCourses(courses);  // Print the sorted course list
+            std::cout << "Here is a sample schedule:\n";
+            printSortedCourses(courses, sortedOrder);  // Print the sorted course list
             break;
         case 3: {  // Option to search for a specific course
             std::string courseNumber;
@@ -141,10 +261,10 @@ int main() {
             break;
         }
         case 9:  // Option to exit the program
-            std::cout << "Thank you for using the course planner!" << std::endl;
+            std::cout << "Thank you for using the course planner!\n";
             return 0;  // Exit the program
         default:  // Handle invalid input from the user
-            std::cout << choice << " is not a valid option." << std::endl;
+            std::cout << choice << " is not a valid option.\n";
         }
     }
 }
\ No newline at end of file